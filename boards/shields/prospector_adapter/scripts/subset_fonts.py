@@ -0,0 +1,615 @@
+#!/usr/bin/env python3
+"""
+Subsets lv_font_conv output to the characters the firmware can show.
+
+Reads the fonts given on the command line (uncompressed lv_font_conv C files),
+keeps only the glyphs for the characters collected from the keymap layer names,
+the SF symbols header and --text, and writes a font with the same name and
+metrics to --output-dir. --bpp requantizes a font to fewer bits per pixel,
+such as 2 bpp for large glyphs where anti-aliasing barely shows. With
+--compress, glyph bitmaps are written in the RLE format of lv_font_conv
+without --no-compress, which LVGL decodes with LV_USE_FONT_COMPRESSED. A flash
+size report, before and after, is printed and written next to the fonts. The
+output only depends on the inputs, so builds are reproducible.
+
+--glyph-cache names a font drawn through the glyph cache. glyph_cache_size.h
+then gets the cache size, in bytes of 8-bit alpha, that holds every layer name
+glyph of those fonts at once, in the case they are shown in (upper case with
+--upper-layer-names), plus the characters of --glyph-cache-text.
+
+For benchmarks, --keep-all keeps every glyph, --suffix renames the written
+fonts so variants can be linked side by side, and --flash-bytes has each font
+define NAME_flash_bytes, the size of its tables as counted by the compiler.
+"""
+
+import argparse
+import pickle
+import re
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+GLYPH_COMMENT_RE = re.compile(r'/\* U\+([0-9A-F]+) ".*?" \*/')
+HEX_RE = re.compile(r"0x([0-9a-fA-F]+)")
+GLYPH_DSC_RE = re.compile(
+    r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+    r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}"
+)
+SF_SYMBOL_RE = re.compile(r'#define\s+SF_SYMBOL_\w+\s+"((?:\\x[0-9A-Fa-f]{2})+)"')
+
+# lv_font_fmt_txt_glyph_dsc_t and lv_font_fmt_txt_cmap_t sizes on 32-bit targets
+GLYPH_DSC_BYTES = 8
+CMAP_BYTES = 20
+# Unicode list offsets of a sparse cmap are 16 bit
+CMAP_MAX_SPAN = 0x10000
+
+# Must match struct resource_pack_header in resources.c
+PACK_MAGIC = b"PSRP"
+PACK_VERSION = 1
+
+
+def c_array(text, name):
+    match = re.search(name + r"\[\]\s*=\s*\{(.*?)\};", text, re.S)
+    return match.group(1) if match else None
+
+
+def c_field(text, name):
+    match = re.search(r"\." + name + r"\s*=\s*(-?\w+)", text)
+    return match.group(1) if match else None
+
+
+def int_list(body):
+    body = re.sub(r"/\*.*?\*/", "", body, flags=re.S)
+    return [int(v, 0) for v in re.findall(r"-?(?:0x[0-9a-fA-F]+|\d+)", body)]
+
+
+class Font:
+    def __init__(self, path):
+        self.path = path
+        text = path.read_text()
+        self.text = text
+
+        self.name = re.search(r"^const lv_font_t (\w+) = \{", text, re.M).group(1)
+        self.guard = re.search(r"^#ifndef (\w+)", text, re.M).group(1)
+        self.size_px = re.search(r"^ \* Size: (.*)$", text, re.M).group(1)
+        self.opts = re.search(r"^ \* Opts: (.*)$", text, re.M).group(1)
+
+        # Glyph ids follow the order of the bitmap blocks, starting at 1
+        bitmap = c_array(text, "glyph_bitmap")
+        blocks = GLYPH_COMMENT_RE.split(bitmap)[1:]
+        self.codepoints = [int(cp, 16) for cp in blocks[0::2]]
+        self.bitmaps = [bytes(int(v, 16) for v in HEX_RE.findall(b)) for b in blocks[1::2]]
+
+        self.glyph_dsc = [tuple(int(v) for v in m) for m in GLYPH_DSC_RE.findall(text)]
+        if len(self.glyph_dsc) != len(self.codepoints) + 1:
+            raise ValueError(f"{path}: glyph descriptions do not match the bitmaps")
+
+        self.bpp = int(c_field(text, "bpp"))
+        self.kern_scale = int(c_field(text, "kern_scale"))
+        self.line_height = int(c_field(text, "line_height"))
+        self.base_line = int(c_field(text, "base_line"))
+        self.underline_position = int(c_field(text, "underline_position"))
+        self.underline_thickness = int(c_field(text, "underline_thickness"))
+        self.cmap_num = int(c_field(text, "cmap_num"))
+        self.cmap_entries = len(int_list(c_array(text, "unicode_list_0") or ""))
+
+        self.kern_left = self.kern_right = self.kern_values = None
+        if c_field(text, "kern_dsc") != "NULL":
+            if c_field(text, "kern_classes") != "1":
+                raise ValueError(f"{path}: only class based kerning is supported")
+            self.kern_left = int_list(c_array(text, "kern_left_class_mapping"))
+            self.kern_right = int_list(c_array(text, "kern_right_class_mapping"))
+            self.kern_values = int_list(c_array(text, "kern_class_values"))
+            self.left_class_cnt = int(c_field(text, "left_class_cnt"))
+            self.right_class_cnt = int(c_field(text, "right_class_cnt"))
+
+    def requantize(self, bpp):
+        """Rounds every pixel to bpp bits, which must not be more than the font has."""
+        if bpp not in (1, 2, 4, 8) or bpp > self.bpp:
+            raise ValueError(f"{self.name}: cannot requantize {self.bpp} bpp to {bpp} bpp")
+
+        src_max = (1 << self.bpp) - 1
+        dst_max = (1 << bpp) - 1
+        for i, bitmap in enumerate(self.bitmaps):
+            _, _, box_w, box_h, _, _ = self.glyph_dsc[i + 1]
+            pixels = unpack_pixels(bitmap, self.bpp, box_w * box_h)
+            out = BitWriter()
+            for v in pixels:
+                out.write((v * dst_max + src_max // 2) // src_max, bpp)
+            self.bitmaps[i] = out.bytes()
+        self.bpp = bpp
+
+    def kern_bytes(self, glyphs):
+        if self.kern_values is None:
+            return 0
+        return 2 * (glyphs + 1) + len(self.kern_values)
+
+    def size(self):
+        return (
+            sum(len(b) for b in self.bitmaps)
+            + GLYPH_DSC_BYTES * len(self.glyph_dsc)
+            + CMAP_BYTES * self.cmap_num
+            + 2 * self.cmap_entries
+            + self.kern_bytes(len(self.codepoints))
+        )
+
+
+class BitWriter:
+    def __init__(self):
+        self.bits = []
+
+    def write(self, value, width):
+        self.bits.extend((value >> (width - 1 - i)) & 1 for i in range(width))
+
+    def bytes(self):
+        padded = self.bits + [0] * (-len(self.bits) % 8)
+        return bytes(
+            int("".join(map(str, padded[i : i + 8])), 2) for i in range(0, len(padded), 8)
+        )
+
+
+def unpack_pixels(bitmap, bpp, count):
+    per_byte = 8 // bpp
+    mask = (1 << bpp) - 1
+    return [
+        (bitmap[i // per_byte] >> (8 - bpp * (i % per_byte + 1))) & mask for i in range(count)
+    ]
+
+
+def rle_encode(pixels, bpp):
+    """
+    Mirrors rle_next() in LVGL's lv_font_fmt_txt.c: a value read twice in a
+    row starts a run of 1 bits, and the 11th repeat is followed by a 6-bit
+    count of further repeats.
+    """
+    out = BitWriter()
+    repeating = False
+    prev = None
+    cnt = 0
+    i = 0
+
+    while i < len(pixels):
+        if not repeating:
+            out.write(pixels[i], bpp)
+            repeating = prev is not None and pixels[i] == prev
+            cnt = 0
+            prev = pixels[i]
+            i += 1
+            continue
+
+        cnt += 1
+        if pixels[i] != prev:
+            out.write(0, 1)
+            out.write(pixels[i], bpp)
+            prev = pixels[i]
+            repeating = False
+            i += 1
+            continue
+
+        out.write(1, 1)
+        i += 1
+        if cnt < 11:
+            continue
+
+        more = 0
+        while i + more < len(pixels) and pixels[i + more] == prev and more < 62:
+            more += 1
+        out.write(more + 1, 6)
+        i += more
+        # The value after the counted repeats is always a literal
+        if i < len(pixels):
+            out.write(pixels[i], bpp)
+            prev = pixels[i]
+            i += 1
+        repeating = False
+
+    return out.bytes()
+
+
+def rle_glyph(bitmap, bpp, box_w, box_h):
+    """Compresses one glyph, with each row XORed with the row above first."""
+    pixels = unpack_pixels(bitmap, bpp, box_w * box_h)
+    filtered = pixels[:box_w]
+    for y in range(1, box_h):
+        row = pixels[y * box_w : (y + 1) * box_w]
+        above = pixels[(y - 1) * box_w : y * box_w]
+        filtered += [a ^ b for a, b in zip(row, above)]
+    return rle_encode(filtered, bpp)
+
+
+def write_pack(pack, path, header_path):
+    """
+    Writes the resource pack: a 16 byte header of magic, version, data size and
+    CRC-32 of the data, then the glyph bitmaps. The header file lets the
+    firmware check that the pack in flash is the one it was built with.
+    """
+    crc = zlib.crc32(pack)
+    header = struct.pack("<4sHHII", PACK_MAGIC, PACK_VERSION, 0, len(pack), crc)
+    path.write_bytes(header + pack)
+    header_path.write_text(
+        "/* Generated by subset_fonts.py, do not edit */\n\n"
+        "#pragma once\n\n"
+        f"#define PROSPECTOR_RESOURCE_PACK_VERSION {PACK_VERSION}\n"
+        f"#define PROSPECTOR_RESOURCE_PACK_SIZE {len(pack)}\n"
+        f"#define PROSPECTOR_RESOURCE_PACK_CRC 0x{crc:08x}\n"
+    )
+
+
+def write_ihex(data, path, address):
+    """Intel HEX of data at address, for programmers that write QSPI flash through its XIP range."""
+    lines = []
+    upper = None
+    for offset in range(0, len(data), 16):
+        addr = address + offset
+        if addr >> 16 != upper:
+            upper = addr >> 16
+            lines.append(ihex_record(0, 4, upper.to_bytes(2, "big")))
+        lines.append(ihex_record(addr & 0xFFFF, 0, data[offset : offset + 16]))
+    lines.append(ihex_record(0, 1, b""))
+    path.write_text("\n".join(lines) + "\n")
+
+
+def ihex_record(addr, kind, data):
+    record = bytes([len(data)]) + addr.to_bytes(2, "big") + bytes([kind]) + data
+    return ":" + (record + bytes([-sum(record) & 0xFF])).hex().upper()
+
+
+def subset_opts(font, compress):
+    """
+    Returns the lv_font_conv options of font with --bpp and compression set to
+    what write_subset produces, so the header describes the bitmaps below it.
+    """
+    opts = re.sub(r"--bpp \d+", f"--bpp {font.bpp}", font.opts)
+    if compress:
+        return re.sub(r" --no-compress\b", "", opts)
+    if "--no-compress" not in opts:
+        opts = opts.replace(f"--bpp {font.bpp}", f"--bpp {font.bpp} --no-compress")
+    return opts
+
+
+def cmap_groups(codepoints):
+    groups = []
+    for cp in codepoints:
+        if groups and cp - groups[-1][0] < CMAP_MAX_SPAN:
+            groups[-1].append(cp)
+        else:
+            groups.append([cp])
+    return groups
+
+
+def format_rows(values, per_row, fmt):
+    rows = []
+    for i in range(0, len(values), per_row):
+        rows.append("    " + ", ".join(fmt(v) for v in values[i : i + per_row]))
+    return ",\n".join(rows)
+
+
+def write_subset(font, keep, out_dir, compress, pack=None, flash_bytes=False):
+    """
+    Writes font restricted to the codepoints in keep, returns the bytes it
+    takes in internal flash. With no out_dir, only the size is computed. With
+    a pack, glyph bitmaps are appended to it instead, and the font reads them
+    through PROSPECTOR_RESOURCE(). With flash_bytes, the font also defines
+    NAME_flash_bytes, the exact size of its const tables on the target.
+    """
+    ids = [i for i, cp in enumerate(font.codepoints) if cp in keep]
+    codepoints = [font.codepoints[i] for i in ids]
+    groups = cmap_groups(codepoints)
+
+    bitmaps = []
+    for i in ids:
+        bitmap = font.bitmaps[i]
+        if compress and bitmap:
+            _, _, box_w, box_h, _, _ = font.glyph_dsc[i + 1]
+            bitmap = rle_glyph(bitmap, font.bpp, box_w, box_h)
+        bitmaps.append(bitmap)
+
+    bitmap_index = []
+    offset = 0
+    for bitmap in bitmaps:
+        bitmap_index.append(offset)
+        offset += len(bitmap)
+
+    out = []
+    out.append("#include <lvgl.h>\n")
+    if pack is not None:
+        out.append("#include <prospector/resources.h>\n")
+    out.append("/" + "*" * 79 + "\n")
+    out.append(f" * Size: {font.size_px}\n")
+    out.append(f" * Bpp: {font.bpp}\n")
+    out.append(f" * Opts: {subset_opts(font, compress)}\n")
+    out.append(f" * Subset: {len(ids)} of {len(font.codepoints)} glyphs by subset_fonts.py, do not edit\n")
+    out.append(" " + "*" * 78 + "/\n\n")
+    out.append(f"#ifndef {font.guard}\n#define {font.guard} 1\n#endif\n\n#if {font.guard}\n\n")
+
+    if pack is not None:
+        pack.extend(b"\0" * (-len(pack) % 4))
+        glyph_bitmap = f"PROSPECTOR_RESOURCE(0x{len(pack):x})"
+        for bitmap in bitmaps:
+            pack.extend(bitmap)
+    else:
+        glyph_bitmap = "glyph_bitmap"
+        out.append("static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {\n")
+        for cp, bitmap in zip(codepoints, bitmaps):
+            out.append(f"    /* U+{cp:04X} */\n")
+            if bitmap:
+                out.append(format_rows(list(bitmap), 8, lambda v: f"0x{v:x}") + ",\n")
+            out.append("\n")
+        if offset == 0:
+            out.append("    0x0,\n")
+        out.append("};\n\n")
+
+    out.append("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n")
+    out.append("    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */")
+    for index, i in zip(bitmap_index, ids):
+        _, adv_w, box_w, box_h, ofs_x, ofs_y = font.glyph_dsc[i + 1]
+        out.append(
+            f",\n    {{.bitmap_index = {index}, .adv_w = {adv_w}, .box_w = {box_w}, "
+            f".box_h = {box_h}, .ofs_x = {ofs_x}, .ofs_y = {ofs_y}}}"
+        )
+    out.append("\n};\n\n")
+
+    for n, group in enumerate(groups):
+        offsets = [cp - group[0] for cp in group]
+        out.append(f"static const uint16_t unicode_list_{n}[] = {{\n")
+        out.append(format_rows(offsets, 8, lambda v: f"0x{v:x}") + "\n};\n\n")
+
+    out.append("static const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n")
+    glyph_id = 1
+    entries = []
+    for n, group in enumerate(groups):
+        entries.append(
+            f"    {{\n        .range_start = {group[0]}, .range_length = {group[-1] - group[0] + 1}, "
+            f".glyph_id_start = {glyph_id},\n        .unicode_list = unicode_list_{n}, "
+            f".glyph_id_ofs_list = NULL, .list_length = {len(group)}, "
+            f".type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY\n    }}"
+        )
+        glyph_id += len(group)
+    out.append(",\n".join(entries) + "\n};\n\n")
+
+    if font.kern_values is not None:
+        left = [0] + [font.kern_left[i + 1] for i in ids]
+        right = [0] + [font.kern_right[i + 1] for i in ids]
+        out.append("static const uint8_t kern_left_class_mapping[] =\n{\n")
+        out.append(format_rows(left, 8, str) + "\n};\n\n")
+        out.append("static const uint8_t kern_right_class_mapping[] =\n{\n")
+        out.append(format_rows(right, 8, str) + "\n};\n\n")
+        out.append("static const int8_t kern_class_values[] =\n{\n")
+        out.append(format_rows(font.kern_values, 8, str) + "\n};\n\n")
+        out.append("static const lv_font_fmt_txt_kern_classes_t kern_classes =\n{\n")
+        out.append("    .class_pair_values   = kern_class_values,\n")
+        out.append("    .left_class_mapping  = kern_left_class_mapping,\n")
+        out.append("    .right_class_mapping = kern_right_class_mapping,\n")
+        out.append(f"    .left_class_cnt      = {font.left_class_cnt},\n")
+        out.append(f"    .right_class_cnt     = {font.right_class_cnt},\n")
+        out.append("};\n\n")
+
+    has_kern = font.kern_values is not None
+    out.append("#if LVGL_VERSION_MAJOR == 8\nstatic lv_font_fmt_txt_glyph_cache_t cache;\n#endif\n\n")
+    out.append("static const lv_font_fmt_txt_dsc_t font_dsc = {\n")
+    out.append(f"    .glyph_bitmap = {glyph_bitmap},\n")
+    out.append("    .glyph_dsc = glyph_dsc,\n")
+    out.append("    .cmaps = cmaps,\n")
+    out.append(f"    .kern_dsc = {'&kern_classes' if has_kern else 'NULL'},\n")
+    out.append(f"    .kern_scale = {font.kern_scale},\n")
+    out.append(f"    .cmap_num = {len(groups)},\n")
+    out.append(f"    .bpp = {font.bpp},\n")
+    out.append(f"    .kern_classes = {1 if has_kern else 0},\n")
+    # LV_FONT_FMT_TXT_COMPRESSED, with the row prefilter
+    out.append(f"    .bitmap_format = {1 if compress else 0},\n")
+    out.append("#if LVGL_VERSION_MAJOR == 8\n    .cache = &cache\n#endif\n};\n\n")
+
+    out.append(f"const lv_font_t {font.name} = {{\n")
+    out.append("    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,\n")
+    out.append("    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,\n")
+    out.append(f"    .line_height = {font.line_height},\n")
+    out.append(f"    .base_line = {font.base_line},\n")
+    out.append("    .subpx = LV_FONT_SUBPX_NONE,\n")
+    out.append(f"    .underline_position = {font.underline_position},\n")
+    out.append(f"    .underline_thickness = {font.underline_thickness},\n")
+    out.append("    .dsc = &font_dsc,\n")
+    out.append("#if LV_VERSION_CHECK(8, 2, 0) || LVGL_VERSION_MAJOR >= 9\n    .fallback = NULL,\n#endif\n")
+    out.append("    .user_data = NULL,\n};\n\n")
+
+    if flash_bytes:
+        tables = ([] if pack is not None else ["glyph_bitmap"]) + ["glyph_dsc"]
+        tables += [f"unicode_list_{n}" for n in range(len(groups))] + ["cmaps"]
+        if has_kern:
+            tables += [
+                "kern_left_class_mapping",
+                "kern_right_class_mapping",
+                "kern_class_values",
+                "kern_classes",
+            ]
+        tables += ["font_dsc", font.name]
+        out.append("/* Internal flash taken by the tables above */\n")
+        out.append(f"const size_t {font.name}_flash_bytes =\n    ")
+        out.append(" +\n    ".join(f"sizeof({t})" for t in tables) + ";\n\n")
+
+    out.append(f"#endif /*#if {font.guard}*/\n")
+
+    if out_dir is not None:
+        (out_dir / f"{font.name}.c").write_text("".join(out))
+
+    return (
+        (offset if pack is None else 0)
+        + GLYPH_DSC_BYTES * (len(ids) + 1)
+        + CMAP_BYTES * len(groups)
+        + 2 * len(codepoints)
+        + font.kern_bytes(len(ids))
+    )
+
+
+def layer_names(edt_pickle, zephyr_base):
+    sys.path.insert(0, str(Path(zephyr_base) / "scripts" / "dts" / "python-devicetree" / "src"))
+    with open(edt_pickle, "rb") as f:
+        edt = pickle.load(f)
+
+    names = []
+    for keymap in edt.compat2okay.get("zmk,keymap", []):
+        for index, layer in enumerate(keymap.children.values()):
+            # Same precedence as LAYER_NAME() in layer_names.c
+            for prop in ("display-name", "label"):
+                if prop in layer.props:
+                    names.append(layer.props[prop].val)
+                    break
+            else:
+                names.append(str(index))
+    return names
+
+
+def write_glyph_cache_size(fonts, chars, path):
+    glyphs = 0
+    size = 0
+    for font in fonts:
+        for i, cp in enumerate(font.codepoints):
+            if cp in chars:
+                _, _, box_w, box_h, _, _ = font.glyph_dsc[i + 1]
+                glyphs += 1
+                size += box_w * box_h
+
+    path.write_text(
+        "/* Generated by subset_fonts.py: every layer name glyph of the cached fonts */\n"
+        f"#define PROSPECTOR_LAYER_GLYPHS      {glyphs}\n"
+        f"#define PROSPECTOR_LAYER_GLYPH_BYTES {size}\n"
+    )
+    return glyphs, size
+
+
+def sf_symbol_chars(header):
+    chars = set()
+    for escaped in SF_SYMBOL_RE.findall(Path(header).read_text()):
+        chars |= set(bytes.fromhex(escaped.replace("\\x", "")).decode("utf-8"))
+    return chars
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("fonts", nargs="+", type=Path, help="lv_font_conv C files to subset")
+    parser.add_argument("--output-dir", type=Path, required=True)
+    parser.add_argument("--edt", help="edt.pickle of the build, for the keymap layer names")
+    parser.add_argument("--zephyr-base", help="Zephyr tree, to unpickle --edt")
+    parser.add_argument("--sf-symbols", help="Header with the SF_SYMBOL_* strings in use")
+    parser.add_argument("--text", default="", help="Other characters to keep")
+    parser.add_argument("--compress", action="store_true", help="RLE compress glyph bitmaps")
+    parser.add_argument("--keep-all", action="store_true", help="Keep every glyph of every font")
+    parser.add_argument("--suffix", default="", help="Append this to the written fonts' names")
+    parser.add_argument(
+        "--flash-bytes", action="store_true", help="Define NAME_flash_bytes in every font"
+    )
+    parser.add_argument(
+        "--glyph-cache",
+        action="append",
+        default=[],
+        metavar="FONT",
+        help="Size glyph_cache_size.h for FONT's layer name glyphs, may be repeated",
+    )
+    parser.add_argument(
+        "--glyph-cache-text", default="", help="Other characters drawn in --glyph-cache fonts"
+    )
+    parser.add_argument(
+        "--upper-layer-names",
+        action="store_true",
+        help="Layer names are shown in upper case, as with CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS",
+    )
+    parser.add_argument(
+        "--bpp",
+        action="append",
+        default=[],
+        metavar="FONT=BPP",
+        help="Requantize FONT down to BPP (1, 2 or 4) bits per pixel, may be repeated",
+    )
+    parser.add_argument("--pack", type=Path, help="Move glyph bitmaps to this resource pack")
+    parser.add_argument(
+        "--pack-address", type=lambda v: int(v, 0), help="Also write the pack as Intel HEX here"
+    )
+    args = parser.parse_args()
+
+    keep = set(args.text)
+    cached = set(args.glyph_cache_text)
+    if args.edt:
+        for name in layer_names(args.edt, args.zephyr_base):
+            # Either case, so CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS needs no rebuild of the set
+            keep |= set(name) | set(name.upper()) | set(name.lower())
+            cached |= set(name.upper() if args.upper_layer_names else name)
+    if args.sf_symbols:
+        keep |= sf_symbol_chars(args.sf_symbols)
+    # Unnamed layers fall back to their index
+    keep |= set("0123456789")
+    keep = {ord(c) for c in keep}
+    cached = {ord(c) for c in cached}
+
+    args.output_dir.mkdir(parents=True, exist_ok=True)
+
+    pack = bytearray() if args.pack else None
+    bpp = {}
+    for option in args.bpp:
+        name, _, value = option.partition("=")
+        if value not in ("1", "2", "4"):
+            parser.error(f"--bpp {option}: BPP must be 1, 2 or 4")
+        bpp[name] = int(value)
+
+    rows = []
+    cached_fonts = []
+    for path in args.fonts:
+        font = Font(path)
+        if font.name in args.glyph_cache:
+            cached_fonts.append(font)
+        before = font.size()
+        before_bpp = font.bpp
+        # Requantizing only drops precision, lv_font_conv has to regenerate deeper fonts
+        if bpp.get(font.name, 0) > font.bpp:
+            sys.exit(
+                f"{font.name} is {font.bpp} bpp and cannot be requantized up to "
+                f"{bpp[font.name]} bpp"
+            )
+        if font.name in bpp and bpp[font.name] != font.bpp:
+            font.requantize(bpp[font.name])
+        font.name += args.suffix
+        font_keep = set(font.codepoints) if args.keep_all else keep
+        # Both variants are sized so the report shows what compression buys
+        raw = write_subset(font, font_keep, None, False)
+        rle = write_subset(font, font_keep, None, True)
+        write_subset(font, font_keep, args.output_dir, args.compress, pack, args.flash_bytes)
+        kept = sum(1 for cp in font.codepoints if cp in font_keep)
+        rows.append(
+            (font.name, len(font.codepoints), kept, f"{before_bpp}>{font.bpp}", before, raw, rle)
+        )
+
+    width = max(len(r[0]) for r in rows)
+    lines = [
+        f"{'Font':<{width}}  Glyphs  Bpp  Before B  Subset B  RLE B  Written",
+        "-" * (width + 50),
+    ]
+    written = ("RLE" if args.compress else "subset") + (" + pack" if args.pack else "")
+    for name, glyphs, kept, depth, before, raw, rle in rows:
+        lines.append(
+            f"{name:<{width}}  {kept:>3}/{glyphs:<3} {depth:<4} {before:>8} {raw:>9} {rle:>6}  {written}"
+        )
+    totals = [sum(r[i] for r in rows) for i in (4, 5, 6)]
+    lines.append(
+        f"{'Total':<{width}}  {'':12} {totals[0]:>8} {totals[1]:>9} {totals[2]:>6}"
+    )
+    if pack is not None:
+        write_pack(pack, args.pack, args.output_dir / "resource_pack.h")
+        if args.pack_address is not None:
+            write_ihex(args.pack.read_bytes(), args.pack.with_suffix(".hex"), args.pack_address)
+        lines.append(f"Resource pack: {len(pack)} bytes of glyph bitmaps moved to {args.pack.name}")
+    if args.glyph_cache:
+        glyphs, size = write_glyph_cache_size(
+            cached_fonts, cached, args.output_dir / "glyph_cache_size.h"
+        )
+        lines.append(f"Glyph cache: {size} bytes for the {glyphs} layer name glyphs")
+    if not args.keep_all:
+        lines.append(
+            f"Characters kept: {''.join(sorted(chr(cp) for cp in keep if cp < 0x10000))!r}"
+        )
+
+    report = "\n".join(lines) + "\n"
+    (args.output_dir / "font_subset_report.txt").write_text(report)
+    print(report, end="")
+
+
+if __name__ == "__main__":
+    main()
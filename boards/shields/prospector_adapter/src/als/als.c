@@ -0,0 +1,87 @@
+#include "als.h"
+
+#include <zephyr/drivers/sensor.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(als, 4);
+
+#if DT_NODE_HAS_COMPAT(ALS_NODE, zmk_prospector_ambient_light_sensor)
+// Any driver reporting SENSOR_CHAN_LIGHT, with its range given in devicetree
+#define ALS_SENSOR_NODE DT_PHANDLE(ALS_NODE, sensor)
+static const struct als_backend backend = {
+    .name = DT_NODE_FULL_NAME(ALS_SENSOR_NODE),
+    .full_scale_milli = DT_PROP(ALS_NODE, full_scale_milli),
+    .integration_ms = DT_PROP(ALS_NODE, integration_ms),
+};
+#elif DT_NODE_HAS_COMPAT(ALS_NODE, avago_apds9960)
+// Raw clear channel counts at the driver's default gain and ATIME
+static const struct als_backend backend = {
+    .name = "APDS9960",
+    .full_scale_milli = 100 * 1000,
+    .integration_ms = 103,
+};
+#elif DT_NODE_HAS_COMPAT(ALS_NODE, vishay_veml7700)
+// Lux at gain 1, 100 ms integration
+static const struct als_backend backend = {
+    .name = "VEML7700",
+    .full_scale_milli = 400 * 1000,
+    .integration_ms = 100,
+};
+#elif DT_NODE_HAS_COMPAT(ALS_NODE, ti_opt3001)
+// Lux in continuous mode with the default 800 ms conversion time
+static const struct als_backend backend = {
+    .name = "OPT3001",
+    .full_scale_milli = 400 * 1000,
+    .integration_ms = 800,
+};
+#else
+#error "Unsupported ambient light sensor, describe it with a zmk,prospector-ambient-light-sensor node"
+#endif
+
+#ifndef ALS_SENSOR_NODE
+#define ALS_SENSOR_NODE ALS_NODE
+#endif
+
+K_MUTEX_DEFINE(als_sensor_lock);
+
+int als_init(struct als *als) {
+    als->dev = DEVICE_DT_GET(ALS_SENSOR_NODE);
+    als->backend = &backend;
+
+    if (!device_is_ready(als->dev)) {
+        LOG_ERR("%s not ready", backend.name);
+        return -ENODEV;
+    }
+
+    LOG_INF("ALS %s: full scale %d.%03d, %d ms integration", backend.name,
+            backend.full_scale_milli / 1000, backend.full_scale_milli % 1000,
+            backend.integration_ms);
+
+    return 0;
+}
+
+int als_read_normalized(struct als *als, uint32_t min_interval_ms, int32_t *out) {
+    struct sensor_value value;
+    int ret;
+
+    // None of the supported drivers raise a data ready trigger for the light channel
+    k_msleep(MAX(min_interval_ms, als->backend->integration_ms));
+
+    k_mutex_lock(&als_sensor_lock, K_FOREVER);
+    ret = sensor_sample_fetch(als->dev);
+    if (!ret) {
+        ret = sensor_channel_get(als->dev, SENSOR_CHAN_LIGHT, &value);
+    }
+    k_mutex_unlock(&als_sensor_lock);
+
+    if (ret) {
+        return ret;
+    }
+
+    int64_t milli = sensor_value_to_milli(&value);
+    milli = CLAMP(milli, 0, als->backend->full_scale_milli);
+
+    *out = (int32_t)(milli * ALS_NORMALIZED_MAX / als->backend->full_scale_milli);
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+
+// A supported sensor, or a zmk,prospector-ambient-light-sensor node describing another one
+#define ALS_NODE DT_CHOSEN(prospector_ambient_light_sensor)
+
+// Normalized readings are in permille of the backend's full scale
+#define ALS_NORMALIZED_MAX 1000
+
+/*
+ * Describes one light sensor driver. Ranges are in milli-units of whatever
+ * SENSOR_CHAN_LIGHT reports for that driver (raw counts or lux).
+ */
+struct als_backend {
+    const char *name;
+    // Reading that maps to full brightness; anything above is clamped
+    int32_t full_scale_milli;
+    // A new sample is only available this often, polling faster is wasted I2C traffic
+    uint16_t integration_ms;
+};
+
+struct als {
+    const struct device *dev;
+    const struct als_backend *backend;
+};
+
+/*
+ * Held around every fetch from the ALS device. Presence detection reads
+ * proximity from the same APDS9960 on the sensor trigger thread.
+ */
+extern struct k_mutex als_sensor_lock;
+
+int als_init(struct als *als);
+
+/*
+ * Wait at least min_interval_ms for a fresh sample, longer if the sensor needs
+ * it, then return the reading normalized to 0..ALS_NORMALIZED_MAX.
+ */
+int als_read_normalized(struct als *als, uint32_t min_interval_ms, int32_t *out);
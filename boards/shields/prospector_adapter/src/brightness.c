@@ -1,79 +1,367 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
-#include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/pwm.h>
 #include <zephyr/drivers/led.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/printk.h>
 
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+#include <prospector/brightness.h>
+
+#ifdef CONFIG_PROSPECTOR_USE_AMBIENT_LIGHT_SENSOR
+#include "als/als.h"
+#endif
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(als, 4);
 
 static const struct device *pwm_leds_dev = DEVICE_DT_GET_ONE(pwm_leds);
 #define DISP_BL DT_NODE_CHILD_IDX(DT_NODELABEL(disp_bl))
 
-#ifdef CONFIG_PROSPECTOR_USE_AMBIENT_LIGHT_SENSOR
-
-static uint8_t current_brightness = 100;
+static const struct device *display_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
 
-#define SENSOR_MIN      0       // Minimum sensor reading
-#define SENSOR_MAX      100   // Maximum sensor reading
 #define PWM_MIN         1       // Minimum PWM duty cycle (%) - keep display visible
 #define PWM_MAX         100     // Maximum PWM duty cycle (%)
 
 #define FADE_STEP                        1
 #define FADE_SLEEP_BRIGHTEN_MS           3
 #define FADE_SLEEP_DARKEN_MS             10
+#define FADE_SLEEP_WAKE_MS               1
 #define FADE_THRESHOLD                   10
 
+#define OFFSET_LIMIT                     (PWM_MAX - PWM_MIN)
+
+/*
+ * Brightness service. The ALS thread, the brightness behavior, presence
+ * detection and activity changes only post requests to bl_msgq. All state
+ * below is owned by the system work queue: bl_request_work applies the
+ * requests in order and bl_fade_work is the only writer of the PWM, so no
+ * producer ever waits on a lock held by another.
+ */
+enum bl_request_type {
+    BL_REQ_AMBIENT,
+    BL_REQ_ACTIVITY,
+    BL_REQ_BLANK,
+    BL_REQ_OFFSET_ADJUST,
+    BL_REQ_OFFSET_LOAD,
+    BL_REQ_AUTO,
+    BL_REQ_TOGGLE,
+};
+
+struct bl_request {
+    uint8_t type;
+    int8_t value;
+};
+
+K_MSGQ_DEFINE(bl_msgq, sizeof(struct bl_request), 16, 1);
+
+#ifdef CONFIG_PROSPECTOR_USE_AMBIENT_LIGHT_SENSOR
+static uint8_t ambient_level = PWM_MAX;
+#else
+static uint8_t ambient_level = CONFIG_PROSPECTOR_FIXED_BRIGHTNESS;
+#endif
+static int8_t user_offset = 0;
+static bool user_off = false;
+static enum zmk_activity_state activity_state = ZMK_ACTIVITY_ACTIVE;
+static bool bl_display_off = false;
+static bool bl_fast_fade = true;
+static uint8_t bl_current = 0;
+
+#ifdef CONFIG_PROSPECTOR_USE_AMBIENT_LIGHT_SENSOR
+static K_SEM_DEFINE(als_wake_sem, 0, 1);
+#endif
+
+// Mirrors read outside of the system work queue
+static atomic_t bl_blanked = ATOMIC_INIT(0);
+static atomic_t bl_sleeping = ATOMIC_INIT(0);
+
+static int64_t activity_state_since;
+static int64_t activity_state_ms[ZMK_ACTIVITY_SLEEP + 1];
+
+static const char *const activity_state_names[] = {
+    [ZMK_ACTIVITY_ACTIVE] = "active",
+    [ZMK_ACTIVITY_IDLE] = "idle",
+    [ZMK_ACTIVITY_SLEEP] = "sleep",
+};
+
+static bool bl_forced_off(void) {
+    return user_off || atomic_get(&bl_blanked) || activity_state == ZMK_ACTIVITY_SLEEP;
+}
+
+static uint8_t bl_target_level(void) {
+    if (bl_forced_off()) {
+        return 0;
+    }
+
+    uint8_t level = CLAMP(ambient_level + user_offset, PWM_MIN, PWM_MAX);
+
+    if (activity_state == ZMK_ACTIVITY_IDLE) {
+        return MIN(level, CONFIG_PROSPECTOR_IDLE_BRIGHTNESS);
+    }
+
+    return level;
+}
+
+static void bl_fade_work_cb(struct k_work *work) {
+    static uint8_t bl_written = UINT8_MAX;
+
+    uint8_t target = bl_target_level();
+    bool increasing = target > bl_current;
+
+    if (increasing) {
+        bl_current = MIN(bl_current + FADE_STEP, target);
+    } else if (target < bl_current) {
+        bl_current = MAX(bl_current - FADE_STEP, target);
+    }
+
+    if (bl_current != bl_written) {
+        if (led_set_brightness(pwm_leds_dev, DISP_BL, bl_current)) {
+            LOG_ERR("Failed to set brightness");
+        }
+        bl_written = bl_current;
+    }
+
+    if (bl_current == target) {
+        bl_fast_fade = false;
+        return;
+    }
+
+    uint32_t step_ms = bl_fast_fade ? FADE_SLEEP_WAKE_MS
+                       : increasing ? FADE_SLEEP_BRIGHTEN_MS
+                                    : FADE_SLEEP_DARKEN_MS;
+    k_work_schedule(k_work_delayable_from_work(work), K_MSEC(step_ms));
+}
+
+static K_WORK_DELAYABLE_DEFINE(bl_fade_work, bl_fade_work_cb);
+
+// Blank the panel whenever the backlight is forced off, unblank on the way back
+static void bl_update_display(void) {
+    bool off = bl_forced_off();
+    if (off == bl_display_off) {
+        return;
+    }
+
+    LOG_DBG("Display %s", off ? "blanked" : "unblanked");
+
+    bl_display_off = off;
+    if (off) {
+        // Cut the backlight immediately instead of fading out
+        bl_current = 0;
+        display_blanking_on(display_dev);
+    } else {
+        bl_fast_fade = true;
+        display_blanking_off(display_dev);
+    }
+}
+
+static void bl_submit(enum bl_request_type type, int8_t value);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+
+static void bl_save_work_cb(struct k_work *work) {
+    int ret = settings_save_one("prospector/bl_offset", &user_offset, sizeof(user_offset));
+    if (ret < 0) {
+        LOG_ERR("Failed to save brightness offset (err %d)", ret);
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(bl_save_work, bl_save_work_cb);
+
+static int bl_settings_load_cb(const char *name, size_t len, settings_read_cb read_cb,
+                               void *cb_arg) {
+    const char *next;
+    int8_t offset;
+
+    if (settings_name_steq(name, "bl_offset", &next) && !next) {
+        if (len != sizeof(offset)) {
+            return -EINVAL;
+        }
+
+        int rc = read_cb(cb_arg, &offset, sizeof(offset));
+        if (rc >= 0) {
+            bl_submit(BL_REQ_OFFSET_LOAD, offset);
+        }
+        return MIN(rc, 0);
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(prospector_brightness, "prospector", NULL, bl_settings_load_cb,
+                               NULL, NULL);
+
+#endif
+
+static void bl_set_user_offset(int offset) {
+    offset = CLAMP(offset, -OFFSET_LIMIT, OFFSET_LIMIT);
+    if (offset == user_offset) {
+        return;
+    }
+
+    LOG_DBG("Brightness offset %d", offset);
+    user_offset = offset;
+}
+
+static void bl_apply_activity(enum zmk_activity_state state) {
+    int64_t now = k_uptime_get();
+    enum zmk_activity_state prev = activity_state;
+    int64_t spent = now - activity_state_since;
+
+    activity_state_ms[prev] += spent;
+    activity_state_since = now;
+    activity_state = state;
+
+    LOG_INF("Backlight %s -> %s after %u s (total active %u s, idle %u s, sleep %u s)",
+            activity_state_names[prev], activity_state_names[state],
+            (uint32_t)(spent / MSEC_PER_SEC),
+            (uint32_t)(activity_state_ms[ZMK_ACTIVITY_ACTIVE] / MSEC_PER_SEC),
+            (uint32_t)(activity_state_ms[ZMK_ACTIVITY_IDLE] / MSEC_PER_SEC),
+            (uint32_t)(activity_state_ms[ZMK_ACTIVITY_SLEEP] / MSEC_PER_SEC));
+
+    atomic_set(&bl_sleeping, state == ZMK_ACTIVITY_SLEEP);
+#ifdef CONFIG_PROSPECTOR_USE_AMBIENT_LIGHT_SENSOR
+    if (prev == ZMK_ACTIVITY_SLEEP) {
+        k_sem_give(&als_wake_sem);
+    }
+#endif
+
+    if (state == ZMK_ACTIVITY_ACTIVE) {
+        bl_fast_fade = true;
+    }
+}
+
+static void bl_request_work_cb(struct k_work *work) {
+    struct bl_request req;
+    int8_t saved_offset = user_offset;
+
+    while (k_msgq_get(&bl_msgq, &req, K_NO_WAIT) == 0) {
+        switch (req.type) {
+        case BL_REQ_AMBIENT:
+            ambient_level = req.value;
+            break;
+        case BL_REQ_ACTIVITY:
+            bl_apply_activity(req.value);
+            break;
+        case BL_REQ_BLANK:
+            // Already mirrored in bl_blanked, only the display state needs updating
+            break;
+        case BL_REQ_OFFSET_ADJUST:
+            user_off = false;
+            bl_set_user_offset(user_offset + req.value);
+            break;
+        case BL_REQ_OFFSET_LOAD:
+            bl_set_user_offset(req.value);
+            saved_offset = user_offset;
+            break;
+        case BL_REQ_AUTO:
+            user_off = false;
+            bl_set_user_offset(0);
+            break;
+        case BL_REQ_TOGGLE:
+            user_off = !user_off;
+            break;
+        }
+    }
+
+    bl_update_display();
+    k_work_schedule(&bl_fade_work, K_NO_WAIT);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+    if (user_offset != saved_offset) {
+        k_work_reschedule(&bl_save_work, K_MSEC(CONFIG_ZMK_SETTINGS_SAVE_DEBOUNCE));
+    }
+#endif
+}
+
+static K_WORK_DEFINE(bl_request_work, bl_request_work_cb);
+
+static void bl_submit(enum bl_request_type type, int8_t value) {
+    struct bl_request req = {.type = type, .value = value};
+
+    if (k_msgq_put(&bl_msgq, &req, K_NO_WAIT)) {
+        LOG_WRN("Brightness request queue full, dropping request %d", type);
+    }
+    k_work_submit(&bl_request_work);
+}
+
+bool prospector_brightness_is_blanked(void) { return atomic_get(&bl_blanked); }
+
+void prospector_brightness_blank(bool blank) {
+    if (atomic_set(&bl_blanked, blank) != blank) {
+        bl_submit(BL_REQ_BLANK, blank);
+    }
+}
+
+void prospector_brightness_adjust(int8_t delta) { bl_submit(BL_REQ_OFFSET_ADJUST, delta); }
+
+void prospector_brightness_auto(void) { bl_submit(BL_REQ_AUTO, 0); }
+
+void prospector_brightness_toggle(void) { bl_submit(BL_REQ_TOGGLE, 0); }
+
+#ifdef CONFIG_PROSPECTOR_USE_AMBIENT_LIGHT_SENSOR
+
 #define NORMAL_SAMPLE_SLEEP_MS           100
 
 #define BURST_SAMPLE_SLEEP_MS            30
 #define BURST_SAMPLE_TIMEOUT             10
 #define BURST_SAMPLE_CONSECUTIVE         3
 
-uint8_t map_light_to_pwm(int32_t sensor_reading) {
+static struct als als;
+
+uint8_t map_light_to_pwm(int32_t normalized) {
     // Handle invalid/error readings
-    if (sensor_reading < SENSOR_MIN) {
+    if (normalized < 0) {
         return PWM_MIN;  // Default to minimum brightness on error
     }
 
     // Clamp to maximum
-    if (sensor_reading > SENSOR_MAX) {
-        sensor_reading = SENSOR_MAX;
+    if (normalized > ALS_NORMALIZED_MAX) {
+        normalized = ALS_NORMALIZED_MAX;
     }
 
     // Linear mapping
-    uint8_t pwm_value = (uint8_t)(
-        PWM_MIN + ((PWM_MAX - PWM_MIN) *
-        (sensor_reading - SENSOR_MIN)) / (SENSOR_MAX - SENSOR_MIN)
-    );
-
-    return pwm_value;
+    return (uint8_t)(PWM_MIN + ((PWM_MAX - PWM_MIN) * normalized) / ALS_NORMALIZED_MAX);
 }
 
-uint8_t bl_fade(uint8_t source, uint8_t target) {
-    bool increasing = target > source;
-
-    while ((increasing && current_brightness < target) ||
-           (!increasing && current_brightness > target)) {
-
-        if (led_set_brightness(pwm_leds_dev, DISP_BL, current_brightness)) {
-            LOG_ERR("Failed to set brightness");
-        }
-
-        current_brightness += increasing ? FADE_STEP : -FADE_STEP;
+static uint8_t als_sample(uint32_t min_interval_ms) {
+    int32_t normalized;
 
-        // Ensure we don't overshoot bounds
-        if (current_brightness > 100) {
-            current_brightness = 100;
-        } else if (current_brightness < 0) {
-            current_brightness = 0;
-        }
-
-        k_msleep(increasing ? FADE_SLEEP_BRIGHTEN_MS : FADE_SLEEP_DARKEN_MS);
+    if (als_read_normalized(&als, min_interval_ms, &normalized)) {
+        LOG_ERR("Cannot read ALS data");
+        normalized = -1;
     }
 
-    return 0;
+    return map_light_to_pwm(normalized);
+}
+
+/*
+ * Presence detection needs the APDS9960 proximity interrupt to wake the
+ * display, so that sensor stays powered while the ALS thread is parked.
+ */
+#if defined(CONFIG_PM_DEVICE) &&                                                                   \
+    !(IS_ENABLED(CONFIG_PROSPECTOR_PRESENCE_DETECTION) &&                                          \
+      DT_NODE_HAS_COMPAT(ALS_NODE, avago_apds9960))
+#define ALS_SUSPEND_ON_SLEEP 1
+#endif
+
+// Park the thread with the sensor powered down until the keyboard wakes up
+static void als_wait_for_wake(void) {
+#ifdef ALS_SUSPEND_ON_SLEEP
+    pm_device_action_run(als.dev, PM_DEVICE_ACTION_SUSPEND);
+#endif
+
+    LOG_DBG("ALS parked");
+    k_sem_take(&als_wake_sem, K_FOREVER);
+
+#ifdef ALS_SUSPEND_ON_SLEEP
+    pm_device_action_run(als.dev, PM_DEVICE_ACTION_RESUME);
+#endif
 }
 
 extern void als_thread(void *d0, void *d1, void *d2) {
@@ -81,78 +369,67 @@ extern void als_thread(void *d0, void *d1, void *d2) {
     ARG_UNUSED(d1);
     ARG_UNUSED(d2);
 
-    const struct device *dev;
-    struct sensor_value intensity;
     uint8_t mapped_brightness;
+    uint8_t als_level = PWM_MAX;
 
-    dev = DEVICE_DT_GET_ONE(avago_apds9960);
-    if (!device_is_ready(dev)) {
+    if (als_init(&als)) {
         printk("sensor: device not ready.\n");
+        return;
     }
 
-    // led_set_brightness(pwm_leds_dev, DISP_BL, 100);
-
     while (1) {
 
-        k_msleep(NORMAL_SAMPLE_SLEEP_MS);
-
-
-        if (sensor_sample_fetch(dev)) {
-            LOG_ERR("sensor_sample fetch failed\n");
-        }
-
-        if (sensor_channel_get(dev, SENSOR_CHAN_LIGHT, &intensity)) {
-            LOG_ERR("Cannot read ALS data.\n");
+        if (atomic_get(&bl_sleeping)) {
+            als_wait_for_wake();
         }
 
-        // LOG_INF("ambient light intensity %d", intensity.val1);
-
-        mapped_brightness = map_light_to_pwm(intensity.val1);
+        mapped_brightness = als_sample(NORMAL_SAMPLE_SLEEP_MS);
         // LOG_INF("NORMAL: mapped PWM duty cycle %d\n", mapped_brightness);
 
-        if (abs(mapped_brightness - current_brightness) > FADE_THRESHOLD) {
+        if (abs(mapped_brightness - als_level) > FADE_THRESHOLD) {
             uint8_t integrator = 0;
 
             for (int i = 0; i < BURST_SAMPLE_TIMEOUT; i++) {
-                k_msleep(BURST_SAMPLE_SLEEP_MS);
-
-                if (sensor_sample_fetch(dev)) {
-                    LOG_ERR("sensor_sample fetch failed\n");
-                }
-                if (sensor_channel_get(dev, SENSOR_CHAN_LIGHT, &intensity)) {
-                    LOG_ERR("Cannot read ALS data.\n");
-                }
-
-                mapped_brightness = map_light_to_pwm(intensity.val1);
+                mapped_brightness = als_sample(BURST_SAMPLE_SLEEP_MS);
                 // LOG_INF("BURST: mapped PWM duty cycle %d\n", mapped_brightness);
 
-                if (abs(mapped_brightness - current_brightness) > FADE_THRESHOLD) {
+                if (abs(mapped_brightness - als_level) > FADE_THRESHOLD) {
                     integrator++;
                     // printk("integrator at: %d", integrator);
                     if (integrator >= BURST_SAMPLE_CONSECUTIVE) {
-                        bl_fade(current_brightness, mapped_brightness);
-                        current_brightness = mapped_brightness;
+                        als_level = mapped_brightness;
+                        bl_submit(BL_REQ_AMBIENT, mapped_brightness);
                         // LOG_INF("SETTING NEW BRIGHTNESS: %d", mapped_brightness);
                         break;
                     }
                 }
             }
         }
-        // led_set_brightness(pwm_leds_dev, DISP_BL, map_light_to_pwm(intensity.val1));
     }
 }
 
 K_THREAD_DEFINE(als_tid, 1024, als_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0,
                 0);
 
-#else
+#endif
 
-static int init_fixed_brightness(void) {
-    led_set_brightness(pwm_leds_dev, DISP_BL, CONFIG_PROSPECTOR_FIXED_BRIGHTNESS);
+static int brightness_activity_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+    if (ev != NULL) {
+        bl_submit(BL_REQ_ACTIVITY, ev->state);
+    }
 
-    return 0;
+    return ZMK_EV_EVENT_BUBBLE;
 }
 
-SYS_INIT(init_fixed_brightness, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+ZMK_LISTENER(prospector_brightness, brightness_activity_listener);
+ZMK_SUBSCRIPTION(prospector_brightness, zmk_activity_state_changed);
+
+static int brightness_init(void) {
+    activity_state_since = k_uptime_get();
+    k_work_schedule(&bl_fade_work, K_NO_WAIT);
+
+    return 0;
+}
 
-#endif
\ No newline at end of file
+SYS_INIT(brightness_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -3,42 +3,132 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/display.h>
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_WIDGET_CAROUSEL)
+#include "widgets/layer_carousel.h"
+#else
 #include "widgets/layer_roller.h"
+#endif
+#include "widgets/layer_stack.h"
 #include "widgets/battery_bar.h"
 #include "widgets/caps_word_indicator.h"
+#include "widgets/modifier_indicator.h"
+#include "widgets/wpm.h"
+#include "render_stats.h"
+#include "pages.h"
 
 #include <fonts.h>
 #include <sf_symbols.h>
 
 #include <zmk/keymap.h>
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK)
+#include <prospector/resources.h>
+#endif
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_WIDGET_CAROUSEL)
+static struct zmk_widget_layer_carousel layer_carousel_widget;
+#else
 static struct zmk_widget_layer_roller layer_roller_widget;
+#endif
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_STACK)
+static struct zmk_widget_layer_stack layer_stack_widget;
+#endif
 static struct zmk_widget_battery_bar battery_bar_widget;
 static struct zmk_widget_caps_word_indicator caps_word_indicator_widget;
+#if IS_ENABLED(CONFIG_PROSPECTOR_MODIFIER_INDICATOR)
+static struct zmk_widget_modifier_indicator modifier_indicator_widget;
+#endif
+#if IS_ENABLED(CONFIG_PROSPECTOR_WPM_WIDGET)
+static struct zmk_widget_wpm wpm_widget;
+#endif
 
-lv_obj_t *zmk_display_status_screen() {
-    lv_obj_t *screen;
-    screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(screen, 255, LV_PART_MAIN);
-
+static void status_page_create(lv_obj_t *screen) {
 #ifdef CONFIG_DT_HAS_ZMK_BEHAVIOR_CAPS_WORD_ENABLED
     zmk_widget_caps_word_indicator_init(&caps_word_indicator_widget, screen);
     lv_obj_align(zmk_widget_caps_word_indicator_obj(&caps_word_indicator_widget), LV_ALIGN_RIGHT_MID, -10, 46);
 #endif
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_MODIFIER_INDICATOR)
+    zmk_widget_modifier_indicator_init(&modifier_indicator_widget, screen);
+    lv_obj_align(zmk_widget_modifier_indicator_obj(&modifier_indicator_widget), LV_ALIGN_TOP_RIGHT, -10, 10);
+#endif
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_WPM_WIDGET)
+    zmk_widget_wpm_init(&wpm_widget, screen);
+    lv_obj_align(zmk_widget_wpm_obj(&wpm_widget), LV_ALIGN_TOP_LEFT, 10, 10);
+#endif
+
     zmk_widget_battery_bar_init(&battery_bar_widget, screen);
     // lv_obj_set_width(zmk_widget_battery_bar_obj(&battery_bar_widget), lv_pct(100));
     lv_obj_set_size(zmk_widget_battery_bar_obj(&battery_bar_widget), lv_pct(100), 48);
     lv_obj_align(zmk_widget_battery_bar_obj(&battery_bar_widget), LV_ALIGN_BOTTOM_MID, 0, 0);
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_WIDGET_CAROUSEL)
+    zmk_widget_layer_carousel_init(&layer_carousel_widget, screen);
+    lv_obj_set_size(zmk_widget_layer_carousel_obj(&layer_carousel_widget), 224, 140);
+    lv_obj_align(zmk_widget_layer_carousel_obj(&layer_carousel_widget), LV_ALIGN_LEFT_MID, 0, -20);
+#else
     zmk_widget_layer_roller_init(&layer_roller_widget, screen);
     lv_obj_set_size(zmk_widget_layer_roller_obj(&layer_roller_widget), 224, 140);
     lv_obj_align(zmk_widget_layer_roller_obj(&layer_roller_widget), LV_ALIGN_LEFT_MID, 0, -20);
+#endif
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_STACK)
+    zmk_widget_layer_stack_init(&layer_stack_widget, screen);
+    lv_obj_align(zmk_widget_layer_stack_obj(&layer_stack_widget), LV_ALIGN_RIGHT_MID, -18, -20);
+#endif
+}
+
+static void status_page_destroy(void) {
+#ifdef CONFIG_DT_HAS_ZMK_BEHAVIOR_CAPS_WORD_ENABLED
+    zmk_widget_caps_word_indicator_deinit(&caps_word_indicator_widget);
+#endif
+#if IS_ENABLED(CONFIG_PROSPECTOR_MODIFIER_INDICATOR)
+    zmk_widget_modifier_indicator_deinit(&modifier_indicator_widget);
+#endif
+#if IS_ENABLED(CONFIG_PROSPECTOR_WPM_WIDGET)
+    zmk_widget_wpm_deinit(&wpm_widget);
+#endif
+    zmk_widget_battery_bar_deinit(&battery_bar_widget);
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_WIDGET_CAROUSEL)
+    zmk_widget_layer_carousel_deinit(&layer_carousel_widget);
+#else
+    zmk_widget_layer_roller_deinit(&layer_roller_widget);
+#endif
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_STACK)
+    zmk_widget_layer_stack_deinit(&layer_stack_widget);
+#endif
+}
+
+const struct prospector_page status_page = {
+    .name = "status",
+    .create = status_page_create,
+    .destroy = status_page_destroy,
+};
+
+lv_obj_t *zmk_display_status_screen() {
+    lv_obj_t *screen;
+    screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x000000), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(screen, 255, LV_PART_MAIN);
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK)
+    // Without their glyphs the fonts would draw whatever is in flash
+    if (!prospector_resources_ready()) {
+        lv_obj_t *label = lv_label_create(screen);
+        lv_obj_set_style_text_color(label, lv_color_white(), LV_PART_MAIN);
+        lv_label_set_text_static(label, "Resource pack missing");
+        lv_obj_center(label);
+        return screen;
+    }
+#endif
+
+    pages_init(screen);
 
+    render_stats_init(lv_disp_get_default());
 
     return screen;
 }
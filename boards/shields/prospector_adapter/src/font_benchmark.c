@@ -0,0 +1,168 @@
+#include "widgets/glyph_cache.h"
+#include "widgets/layer_names.h"
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+#include <zmk/display.h>
+#include <zmk/keymap.h>
+
+#include <fonts.h>
+#include <sf_symbols.h>
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK)
+#include <prospector/resources.h>
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Large enough for a 48 px layer name; wider text is clipped but still measured
+#define BENCH_CANVAS_W 160
+#define BENCH_CANVAS_H 56
+#define BENCH_DELAY    K_SECONDS(5)
+
+/*
+ * Draws representative strings in every font in fonts.h into an offscreen
+ * canvas and logs, per font, the time per glyph, the glyph bitmap bytes read
+ * and pixels blended per glyph, and the font's size in internal flash. Meant
+ * to be compared across builds, e.g. with different bpp or compression; the
+ * native_sim benchmark in tests/benchmarks/fonts compares variants in one run.
+ */
+struct font_benchmark_case {
+    const char *name;
+    const lv_font_t *font;
+    // Defined by the subset fonts, see --flash-bytes in subset_fonts.py
+    const size_t *flash_bytes;
+    // NULL for the keymap's layer names
+    const char *text;
+    bool cached;
+};
+
+#define BENCH_CASE(font, text, cached) {#font, &font, &font##_flash_bytes, text, cached}
+
+extern const size_t FRAC_Regular_48_flash_bytes;
+extern const size_t FRAC_Thin_48_flash_bytes;
+extern const size_t FoundryGridnikMedium_20_flash_bytes;
+extern const size_t SF_Compact_Text_Bold_32_flash_bytes;
+
+static const struct font_benchmark_case cases[] = {
+    BENCH_CASE(FRAC_Regular_48, NULL, false),
+    BENCH_CASE(FRAC_Thin_48, NULL, false),
+#if IS_ENABLED(CONFIG_PROSPECTOR_GLYPH_CACHE)
+    BENCH_CASE(FRAC_Regular_48, NULL, true),
+    BENCH_CASE(FRAC_Thin_48, NULL, true),
+#endif
+    BENCH_CASE(FoundryGridnikMedium_20, "100 85 7 N/A 42 WPM", false),
+    BENCH_CASE(SF_Compact_Text_Bold_32,
+               SF_SYMBOL_CONTROL SF_SYMBOL_OPTION SF_SYMBOL_SHIFT SF_SYMBOL_COMMAND
+                   SF_SYMBOL_CHARACTER_CURSOR_IBEAM,
+               false),
+};
+
+static uint8_t canvas_buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR(BENCH_CANVAS_W, BENCH_CANVAS_H)] __aligned(4);
+
+struct text_cost {
+    uint32_t glyphs;
+    uint32_t bitmap_bytes;
+    uint32_t pixels;
+};
+
+// What drawing text reads and blends, glyph by glyph
+static void font_benchmark_measure(const lv_font_t *font, const char *text,
+                                   struct text_cost *cost) {
+    uint32_t i = 0;
+
+    while (text[i] != '\0') {
+        uint32_t letter;
+        uint32_t letter_next;
+        lv_font_glyph_dsc_t g;
+
+        _lv_txt_encoded_letter_next_2(text, &letter, &letter_next, &i);
+        if (!lv_font_get_glyph_dsc(font, &g, letter, letter_next) || g.box_w == 0) {
+            continue;
+        }
+
+        cost->glyphs++;
+        cost->pixels += g.box_w * g.box_h;
+        cost->bitmap_bytes += DIV_ROUND_UP(g.box_w * g.box_h * g.bpp, 8);
+    }
+}
+
+static void font_benchmark_run(lv_obj_t *canvas, const struct font_benchmark_case *c) {
+    const lv_font_t *font = c->cached ? glyph_cache_font(c->font) : c->font;
+    struct text_cost cost = {0};
+    lv_draw_label_dsc_t label;
+
+    lv_draw_label_dsc_init(&label);
+    label.font = font;
+    label.color = lv_color_white();
+
+    uint32_t start = k_cycle_get_32();
+    for (int n = 0; n < CONFIG_PROSPECTOR_FONT_BENCHMARK_ITERATIONS; n++) {
+        if (c->text != NULL) {
+            lv_canvas_draw_text(canvas, 0, 0, BENCH_CANVAS_W, &label, c->text);
+            continue;
+        }
+
+        for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+            lv_canvas_draw_text(canvas, 0, 0, BENCH_CANVAS_W, &label, layer_names_get(i));
+        }
+    }
+    uint64_t ns = k_cyc_to_ns_floor64(k_cycle_get_32() - start);
+
+    if (c->text != NULL) {
+        font_benchmark_measure(font, c->text, &cost);
+    } else {
+        for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+            font_benchmark_measure(font, layer_names_get(i), &cost);
+        }
+    }
+
+    if (cost.glyphs == 0) {
+        LOG_INF("%-24s no glyphs to draw", c->name);
+        return;
+    }
+
+    const char *variant = c->cached ? "cached" : "";
+
+    const lv_font_fmt_txt_dsc_t *dsc = c->font->dsc;
+    uint32_t ns_per_glyph = ns / (cost.glyphs * CONFIG_PROSPECTOR_FONT_BENCHMARK_ITERATIONS);
+
+    LOG_INF("%-24s %-6s %3u %6u %8u %8u %8u %8zu", c->name, variant, dsc->bpp, cost.glyphs,
+            ns_per_glyph, cost.bitmap_bytes / cost.glyphs, cost.pixels / cost.glyphs,
+            *c->flash_bytes);
+}
+
+static void font_benchmark_work_cb(struct k_work *work) {
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK)
+    if (!prospector_resources_ready()) {
+        LOG_WRN("Font benchmark skipped, no resource pack");
+        return;
+    }
+#endif
+
+    lv_obj_t *canvas = lv_canvas_create(NULL);
+    lv_canvas_set_buffer(canvas, canvas_buf, BENCH_CANVAS_W, BENCH_CANVAS_H,
+                         LV_IMG_CF_TRUE_COLOR);
+
+    LOG_INF("Font benchmark, %d iterations", CONFIG_PROSPECTOR_FONT_BENCHMARK_ITERATIONS);
+    LOG_INF("%-24s %-6s %3s %6s %8s %8s %8s %8s", "font", "", "bpp", "glyphs", "ns/glyph",
+            "B/glyph", "px/glyph", "flash B");
+
+    for (int i = 0; i < ARRAY_SIZE(cases); i++) {
+        lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+        font_benchmark_run(canvas, &cases[i]);
+    }
+
+    lv_obj_del(canvas);
+}
+
+static K_WORK_DELAYABLE_DEFINE(font_benchmark_work, font_benchmark_work_cb);
+
+// Runs on the display queue, which owns LVGL, once the screen is up
+static int font_benchmark_init(void) {
+    k_work_schedule_for_queue(zmk_display_work_q(), &font_benchmark_work, BENCH_DELAY);
+    return 0;
+}
+
+SYS_INIT(font_benchmark_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,178 @@
+#include <lvgl.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include <zmk/display.h>
+#include <zmk/physical_layouts.h>
+
+#include "key_heatmap.h"
+#include "pages.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define HEATMAP_W          256
+#define HEATMAP_H          144
+#define HEATMAP_GAP        2
+#define HEATMAP_GRID_COLS  12
+#define HEATMAP_REFRESH_MS 1000
+
+// Index 0 is the background, 1 an unused key, 2..15 the heat ramp
+#define HEATMAP_COLORS     16
+#define HEATMAP_COLOR_BG   0
+#define HEATMAP_COLOR_COLD 1
+#define HEATMAP_PALETTE_SIZE (HEATMAP_COLORS * sizeof(lv_color32_t))
+
+// 4 bits per pixel keeps the whole canvas at ~18 KB
+static uint8_t canvas_buf[LV_CANVAS_BUF_SIZE_INDEXED_4BIT(HEATMAP_W, HEATMAP_H)];
+
+static lv_obj_t *heatmap_canvas;
+static lv_timer_t *refresh_timer;
+static uint32_t drawn_generation;
+
+struct heatmap_rect {
+    lv_coord_t x, y, w, h;
+};
+
+static void heatmap_init_palette(lv_obj_t *canvas) {
+    lv_canvas_set_palette(canvas, HEATMAP_COLOR_BG, lv_color_black());
+    lv_canvas_set_palette(canvas, HEATMAP_COLOR_COLD, lv_color_hex(0x202020));
+
+    // Two segments: dark to the accent cyan, then on to a hot orange
+    lv_color_t cold = lv_color_hex(0x202020);
+    lv_color_t mid = lv_color_hex(0x00a0ff);
+    lv_color_t hot = lv_color_hex(0xff5020);
+    int steps = HEATMAP_COLORS - 2;
+
+    for (int i = 0; i < steps; i++) {
+        lv_opa_t mix = (lv_opa_t)(((i % (steps / 2)) + 1) * LV_OPA_COVER / (steps / 2));
+        lv_color_t c = i < steps / 2 ? lv_color_mix(mid, cold, mix) : lv_color_mix(hot, mid, mix);
+        lv_canvas_set_palette(canvas, HEATMAP_COLOR_COLD + 1 + i, c);
+    }
+}
+
+static void heatmap_fill(lv_obj_t *canvas, const struct heatmap_rect *r, uint8_t index) {
+    lv_img_dsc_t *dsc = lv_canvas_get_img(canvas);
+    lv_color_t c = {.full = index};
+
+    lv_coord_t x2 = MIN(r->x + r->w, HEATMAP_W);
+    lv_coord_t y2 = MIN(r->y + r->h, HEATMAP_H);
+
+    for (lv_coord_t y = MAX(r->y, 0); y < y2; y++) {
+        for (lv_coord_t x = MAX(r->x, 0); x < x2; x++) {
+            lv_img_buf_set_px_color(dsc, x, y, c);
+        }
+    }
+}
+
+/*
+ * Key rectangles in canvas pixels. Uses the selected physical layout when it
+ * carries key geometry (rotation is ignored), otherwise a plain grid.
+ */
+static void heatmap_key_rects(struct heatmap_rect *rects) {
+    const struct zmk_physical_layout *const *layouts;
+    int count = zmk_physical_layouts_get_list(&layouts);
+    int selected = zmk_physical_layouts_get_selected();
+    const struct zmk_physical_layout *layout =
+        selected >= 0 && selected < count ? layouts[selected] : NULL;
+
+    if (layout != NULL && layout->keys != NULL && layout->keys_len >= ZMK_KEYMAP_LEN) {
+        int32_t max_x = 1, max_y = 1;
+        for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+            max_x = MAX(max_x, layout->keys[i].x + layout->keys[i].width);
+            max_y = MAX(max_y, layout->keys[i].y + layout->keys[i].height);
+        }
+
+        // Keep the aspect ratio: scale by whichever side is tighter
+        int32_t num = HEATMAP_W, den = max_x;
+        if ((int64_t)HEATMAP_H * max_x < (int64_t)HEATMAP_W * max_y) {
+            num = HEATMAP_H;
+            den = max_y;
+        }
+
+        for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+            const struct zmk_key_physical_attrs *key = &layout->keys[i];
+            rects[i] = (struct heatmap_rect){
+                .x = key->x * num / den,
+                .y = key->y * num / den,
+                .w = MAX(key->width * num / den - HEATMAP_GAP, 1),
+                .h = MAX(key->height * num / den - HEATMAP_GAP, 1),
+            };
+        }
+        return;
+    }
+
+    int cols = MIN(ZMK_KEYMAP_LEN, HEATMAP_GRID_COLS);
+    int rows = DIV_ROUND_UP(ZMK_KEYMAP_LEN, cols);
+    lv_coord_t size = MIN(HEATMAP_W / cols, HEATMAP_H / rows);
+
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        rects[i] = (struct heatmap_rect){
+            .x = (i % cols) * size,
+            .y = (i / cols) * size,
+            .w = MAX(size - HEATMAP_GAP, 1),
+            .h = MAX(size - HEATMAP_GAP, 1),
+        };
+    }
+}
+
+static void heatmap_draw(void) {
+    static struct heatmap_rect rects[ZMK_KEYMAP_LEN];
+    static bool rects_valid;
+    uint16_t max = 1;
+
+    if (!rects_valid) {
+        heatmap_key_rects(rects);
+        rects_valid = true;
+    }
+
+    drawn_generation = key_heatmap_generation();
+
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        max = MAX(max, key_heatmap_get(i));
+    }
+
+    memset(canvas_buf + HEATMAP_PALETTE_SIZE, 0, sizeof(canvas_buf) - HEATMAP_PALETTE_SIZE);
+
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        uint16_t count = key_heatmap_get(i);
+        uint8_t index = HEATMAP_COLOR_COLD;
+        if (count > 0) {
+            index += 1 + (uint32_t)count * (HEATMAP_COLORS - 3) / max;
+        }
+        heatmap_fill(heatmap_canvas, &rects[i], index);
+    }
+
+    lv_obj_invalidate(heatmap_canvas);
+}
+
+// Only runs while the page is shown, and only redraws when some count changed
+static void heatmap_refresh_timer_cb(lv_timer_t *timer) {
+    if (key_heatmap_generation() != drawn_generation) {
+        heatmap_draw();
+    }
+}
+
+static void heatmap_page_create(lv_obj_t *parent) {
+    // The pixel buffer is static, so only the canvas object itself comes from the LVGL heap
+    heatmap_canvas = lv_canvas_create(parent);
+    lv_canvas_set_buffer(heatmap_canvas, canvas_buf, HEATMAP_W, HEATMAP_H,
+                         LV_IMG_CF_INDEXED_4BIT);
+    heatmap_init_palette(heatmap_canvas);
+    lv_obj_center(heatmap_canvas);
+
+    heatmap_draw();
+    refresh_timer = lv_timer_create(heatmap_refresh_timer_cb, HEATMAP_REFRESH_MS, NULL);
+}
+
+static void heatmap_page_destroy(void) {
+    lv_timer_del(refresh_timer);
+    refresh_timer = NULL;
+    heatmap_canvas = NULL;
+}
+
+const struct prospector_page heatmap_page = {
+    .name = "heatmap",
+    .create = heatmap_page_create,
+    .destroy = heatmap_page_destroy,
+};
@@ -0,0 +1,97 @@
+#include "key_heatmap.h"
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/atomic.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define HEATMAP_SAVE_INTERVAL K_SECONDS(CONFIG_PROSPECTOR_KEY_HEATMAP_SAVE_INTERVAL_S)
+
+static uint16_t counts[ZMK_KEYMAP_LEN];
+static atomic_t generation;
+// Keeps a save from copying counts halfway through an increment
+static struct k_spinlock counts_lock;
+
+uint16_t key_heatmap_get(uint32_t position) {
+    return position < ZMK_KEYMAP_LEN ? counts[position] : 0;
+}
+
+uint32_t key_heatmap_generation(void) { return (uint32_t)atomic_get(&generation); }
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+
+static void heatmap_save_work_cb(struct k_work *work) {
+    static uint16_t snapshot[ZMK_KEYMAP_LEN];
+
+    k_spinlock_key_t key = k_spin_lock(&counts_lock);
+    memcpy(snapshot, counts, sizeof(snapshot));
+    k_spin_unlock(&counts_lock, key);
+
+    int ret = settings_save_one("prospector/heatmap/counts", snapshot, sizeof(snapshot));
+    if (ret < 0) {
+        LOG_ERR("Failed to save key heatmap (err %d)", ret);
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(heatmap_save_work, heatmap_save_work_cb);
+
+static int heatmap_settings_load_cb(const char *name, size_t len, settings_read_cb read_cb,
+                                    void *cb_arg) {
+    const char *next;
+
+    if (settings_name_steq(name, "counts", &next) && !next) {
+        // Counts saved for a different keymap size would land on the wrong keys
+        if (len != sizeof(counts)) {
+            LOG_WRN("Discarding key heatmap saved for %zu keys", len / sizeof(counts[0]));
+            return 0;
+        }
+
+        int rc = read_cb(cb_arg, counts, sizeof(counts));
+        if (rc >= 0) {
+            atomic_inc(&generation);
+        }
+        return MIN(rc, 0);
+    }
+
+    return -ENOENT;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(prospector_heatmap, "prospector/heatmap", NULL,
+                               heatmap_settings_load_cb, NULL, NULL);
+
+#endif
+
+static int heatmap_position_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL || !ev->state || ev->position >= ZMK_KEYMAP_LEN) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&counts_lock);
+    bool counted = counts[ev->position] < UINT16_MAX;
+    if (counted) {
+        counts[ev->position]++;
+    }
+    k_spin_unlock(&counts_lock, key);
+
+    if (counted) {
+        atomic_inc(&generation);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+        // Already pending saves are left alone, so a whole interval of presses is one write
+        k_work_schedule(&heatmap_save_work, HEATMAP_SAVE_INTERVAL);
+#endif
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(prospector_heatmap, heatmap_position_listener);
+ZMK_SUBSCRIPTION(prospector_heatmap, zmk_position_state_changed);
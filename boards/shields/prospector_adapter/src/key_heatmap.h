@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdint.h>
+#include <zmk/matrix.h>
+
+// Press count for a key position, saturating at UINT16_MAX
+uint16_t key_heatmap_get(uint32_t position);
+
+// Changes whenever any count does, so readers can skip redundant redraws
+uint32_t key_heatmap_generation(void);
@@ -0,0 +1,133 @@
+#include "pages.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <zmk/display.h>
+
+#include <prospector/screen.h>
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RENDER_STATS) && LV_MEM_CUSTOM
+#include <lvgl_mem.h>
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+enum page_index {
+    PAGE_STATUS,
+#if IS_ENABLED(CONFIG_PROSPECTOR_KEY_HEATMAP)
+    PAGE_HEATMAP,
+#endif
+    PAGE_COUNT,
+};
+
+static const struct prospector_page *const pages[PAGE_COUNT] = {
+    [PAGE_STATUS] = &status_page,
+#if IS_ENABLED(CONFIG_PROSPECTOR_KEY_HEATMAP)
+    [PAGE_HEATMAP] = &heatmap_page,
+#endif
+};
+
+static lv_obj_t *page_screen;
+static lv_obj_t *page_container;
+static int current_page = -1;
+static int previous_page = PAGE_STATUS;
+
+// Requests from behaviors, folded together until the display queue gets to them
+static atomic_t pending_steps;
+static atomic_t pending_heatmap_toggle;
+
+static void page_log_heap(void) {
+#if IS_ENABLED(CONFIG_PROSPECTOR_RENDER_STATS)
+#if LV_MEM_CUSTOM
+    lvgl_print_heap_info(false);
+#else
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    LOG_INF("LVGL heap: %u B used, %u B max used", mon.total_size - mon.free_size,
+            mon.max_used);
+#endif
+#endif
+}
+
+static void page_show(int index) {
+    if (index == current_page) {
+        return;
+    }
+
+    if (current_page >= 0) {
+        pages[current_page]->destroy();
+        lv_obj_del(page_container);
+        previous_page = current_page;
+    }
+
+    page_container = lv_obj_create(page_screen);
+    lv_obj_remove_style_all(page_container);
+    lv_obj_set_size(page_container, lv_pct(100), lv_pct(100));
+    lv_obj_clear_flag(page_container, LV_OBJ_FLAG_SCROLLABLE);
+
+    current_page = index;
+    pages[index]->create(page_container);
+
+    LOG_DBG("Showing %s page", pages[index]->name);
+    page_log_heap();
+}
+
+#if CONFIG_PROSPECTOR_PAGE_CYCLE_S > 0
+static void page_cycle_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(page_cycle_work, page_cycle_work_cb);
+
+static void page_cycle_restart(void) {
+    k_work_reschedule_for_queue(zmk_display_work_q(), &page_cycle_work,
+                                K_SECONDS(CONFIG_PROSPECTOR_PAGE_CYCLE_S));
+}
+
+static void page_cycle_work_cb(struct k_work *work) {
+    page_show((current_page + 1) % PAGE_COUNT);
+    page_cycle_restart();
+}
+#else
+static void page_cycle_restart(void) {}
+#endif
+
+static void page_request_work_cb(struct k_work *work) {
+    int steps = (int)atomic_clear(&pending_steps);
+    int target = current_page;
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_KEY_HEATMAP)
+    if (atomic_clear(&pending_heatmap_toggle)) {
+        target = current_page == PAGE_HEATMAP ? previous_page : PAGE_HEATMAP;
+    }
+#endif
+
+    target = ((target + steps) % PAGE_COUNT + PAGE_COUNT) % PAGE_COUNT;
+
+    page_show(target);
+    page_cycle_restart();
+}
+
+static K_WORK_DEFINE(page_request_work, page_request_work_cb);
+
+void pages_init(lv_obj_t *screen) {
+    page_screen = screen;
+    page_show(PAGE_STATUS);
+    page_cycle_restart();
+}
+
+void prospector_screen_next(void) {
+    atomic_inc(&pending_steps);
+    k_work_submit_to_queue(zmk_display_work_q(), &page_request_work);
+}
+
+void prospector_screen_prev(void) {
+    atomic_dec(&pending_steps);
+    k_work_submit_to_queue(zmk_display_work_q(), &page_request_work);
+}
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_KEY_HEATMAP)
+void prospector_screen_heatmap_toggle(void) {
+    atomic_set(&pending_heatmap_toggle, true);
+    k_work_submit_to_queue(zmk_display_work_q(), &page_request_work);
+}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * A page owns a set of widgets that only exist while it is shown. create()
+ * builds them inside parent; destroy() detaches them from their listeners
+ * before parent, and with it every object of the page, is deleted. Listeners
+ * of a hidden page keep their cached state and re-render it on the next
+ * create(), so LVGL only ever holds one page at a time.
+ */
+struct prospector_page {
+    const char *name;
+    void (*create)(lv_obj_t *parent);
+    void (*destroy)(void);
+};
+
+extern const struct prospector_page status_page;
+#if IS_ENABLED(CONFIG_PROSPECTOR_KEY_HEATMAP)
+extern const struct prospector_page heatmap_page;
+#endif
+
+// Shows the first page on screen; later switches go through prospector/screen.h
+void pages_init(lv_obj_t *screen);
@@ -0,0 +1,130 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+#include <prospector/brightness.h>
+
+#include "als/als.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define PROX_NEAR       CONFIG_PROSPECTOR_PRESENCE_PROXIMITY_THRESHOLD
+#define PROX_HYSTERESIS 8
+#define PROX_FAR        MAX(PROX_NEAR - PROX_HYSTERESIS, 0)
+#define PROX_MAX        255
+
+#define ABSENCE_TIMEOUT K_SECONDS(CONFIG_PROSPECTOR_PRESENCE_TIMEOUT_S)
+
+static const struct device *prox_dev = DEVICE_DT_GET_ONE(avago_apds9960);
+
+static bool hand_near = false;
+
+static void presence_absent_work_cb(struct k_work *work) {
+    LOG_INF("No presence for %d s, blanking display", CONFIG_PROSPECTOR_PRESENCE_TIMEOUT_S);
+    prospector_brightness_blank(true);
+}
+
+static K_WORK_DELAYABLE_DEFINE(presence_absent_work, presence_absent_work_cb);
+
+static void presence_seen_work_cb(struct k_work *work) {
+    // While a hand hovers over the sensor the absence timer stays stopped
+    if (!hand_near) {
+        k_work_reschedule(&presence_absent_work, ABSENCE_TIMEOUT);
+    }
+    prospector_brightness_blank(false);
+}
+
+static K_WORK_DEFINE(presence_seen_work, presence_seen_work_cb);
+
+/*
+ * Only one edge is armed at a time: while far, interrupt on approach; while
+ * near, interrupt on leaving. This keeps a hovering hand from re-triggering
+ * on every proximity cycle.
+ */
+static int presence_arm_window(bool near) {
+    struct sensor_value lower = {.val1 = near ? PROX_FAR : 0};
+    struct sensor_value upper = {.val1 = near ? PROX_MAX : PROX_NEAR};
+    int ret;
+
+    ret = sensor_attr_set(prox_dev, SENSOR_CHAN_PROX, SENSOR_ATTR_LOWER_THRESH, &lower);
+    if (ret) {
+        return ret;
+    }
+
+    return sensor_attr_set(prox_dev, SENSOR_CHAN_PROX, SENSOR_ATTR_UPPER_THRESH, &upper);
+}
+
+static void presence_trigger_handler(const struct device *dev,
+                                     const struct sensor_trigger *trig) {
+    struct sensor_value prox;
+    int ret;
+
+    // Fetching also clears the interrupt on the sensor
+    k_mutex_lock(&als_sensor_lock, K_FOREVER);
+    ret = sensor_sample_fetch(dev);
+    if (!ret) {
+        ret = sensor_channel_get(dev, SENSOR_CHAN_PROX, &prox);
+    }
+    k_mutex_unlock(&als_sensor_lock);
+
+    if (ret) {
+        LOG_ERR("Cannot read proximity data");
+        return;
+    }
+
+    bool near = hand_near ? prox.val1 > PROX_FAR : prox.val1 >= PROX_NEAR;
+    if (near == hand_near) {
+        return;
+    }
+
+    LOG_DBG("Proximity %d, hand %s", prox.val1, near ? "near" : "gone");
+
+    hand_near = near;
+    if (near) {
+        k_work_cancel_delayable(&presence_absent_work);
+    }
+    k_work_submit(&presence_seen_work);
+
+    if (presence_arm_window(near)) {
+        LOG_ERR("Failed to set proximity thresholds");
+    }
+}
+
+static int presence_position_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev != NULL && ev->state) {
+        k_work_submit(&presence_seen_work);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(prospector_presence, presence_position_listener);
+ZMK_SUBSCRIPTION(prospector_presence, zmk_position_state_changed);
+
+static int presence_init(void) {
+    static const struct sensor_trigger trig = {
+        .type = SENSOR_TRIG_THRESHOLD,
+        .chan = SENSOR_CHAN_PROX,
+    };
+
+    if (!device_is_ready(prox_dev)) {
+        LOG_ERR("Proximity sensor not ready");
+        return -ENODEV;
+    }
+
+    if (presence_arm_window(false) || sensor_trigger_set(prox_dev, &trig, presence_trigger_handler)) {
+        LOG_ERR("Failed to set up proximity trigger");
+        return -EIO;
+    }
+
+    k_work_schedule(&presence_absent_work, ABSENCE_TIMEOUT);
+
+    return 0;
+}
+
+SYS_INIT(presence_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
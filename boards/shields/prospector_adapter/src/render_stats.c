@@ -0,0 +1,78 @@
+#include "render_stats.h"
+#include "widgets/render_profile.h"
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define REPORT_INTERVAL_MS (CONFIG_PROSPECTOR_RENDER_STATS_INTERVAL_S * MSEC_PER_SEC)
+#define BENCHMARK_PERIOD_MS 100
+
+/*
+ * Accumulates LVGL's per-refresh monitor data. Every refresh reports how long
+ * rendering and flushing took and how many pixels were redrawn, so comparing
+ * reports across configurations shows the cost of a rendering technique on
+ * the real panel.
+ */
+static struct {
+    uint32_t frames;
+    uint32_t total_ms;
+    uint32_t max_ms;
+    uint64_t total_px;
+    int64_t window_start;
+} stats;
+
+static void (*chained_monitor_cb)(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px);
+
+static void render_stats_monitor_cb(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px) {
+    if (chained_monitor_cb) {
+        chained_monitor_cb(disp_drv, time, px);
+    }
+
+    stats.frames++;
+    stats.total_ms += time;
+    stats.total_px += px;
+    stats.max_ms = MAX(stats.max_ms, time);
+
+    int64_t now = k_uptime_get();
+    if (now - stats.window_start < REPORT_INTERVAL_MS) {
+        return;
+    }
+
+    // Idle windows produce no callbacks, so only busy periods are reported
+    LOG_INF("Render (%s): %u frames, avg %u ms, max %u ms, avg %u px/frame",
+            PROSPECTOR_RENDER_PROFILE_NAME, stats.frames, stats.total_ms / stats.frames,
+            stats.max_ms, (uint32_t)(stats.total_px / stats.frames));
+
+    stats.frames = 0;
+    stats.total_ms = 0;
+    stats.max_ms = 0;
+    stats.total_px = 0;
+    stats.window_start = now;
+}
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RENDER_BENCHMARK)
+/*
+ * A fixed workload: invalidating the whole screen at a steady rate makes every
+ * frame draw all widgets, so the reported times reflect the render profile and
+ * not whatever happened to change.
+ */
+static void render_benchmark_timer_cb(lv_timer_t *timer) {
+    lv_obj_invalidate(lv_scr_act());
+}
+#endif
+
+void render_stats_init(lv_disp_t *disp) {
+    if (disp == NULL || disp->driver->monitor_cb == render_stats_monitor_cb) {
+        return;
+    }
+
+    chained_monitor_cb = disp->driver->monitor_cb;
+    disp->driver->monitor_cb = render_stats_monitor_cb;
+    stats.window_start = k_uptime_get();
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RENDER_BENCHMARK)
+    lv_timer_create(render_benchmark_timer_cb, BENCHMARK_PERIOD_MS, NULL);
+#endif
+}
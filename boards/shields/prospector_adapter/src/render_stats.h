@@ -0,0 +1,9 @@
+#pragma once
+
+#include <lvgl.h>
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RENDER_STATS)
+void render_stats_init(lv_disp_t *disp);
+#else
+static inline void render_stats_init(lv_disp_t *disp) {}
+#endif
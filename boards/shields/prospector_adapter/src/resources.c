@@ -0,0 +1,121 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/flash/nrf_qspi_nor.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+
+#include <prospector/resources.h>
+#include <resource_pack.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define RESOURCE_PACK_MAGIC 0x50525350 // "PSRP"
+
+// Written by subset_fonts.py
+struct resource_pack_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t size;
+    uint32_t crc;
+} __packed;
+
+BUILD_ASSERT(sizeof(struct resource_pack_header) == PROSPECTOR_RESOURCE_HEADER_SIZE);
+BUILD_ASSERT(PROSPECTOR_RESOURCE_HEADER_SIZE + PROSPECTOR_RESOURCE_PACK_SIZE <=
+                 DT_REG_SIZE(PROSPECTOR_RESOURCE_PARTITION),
+             "Resource pack does not fit prospector_resources_partition");
+
+static const struct device *flash_dev =
+    DEVICE_DT_GET(DT_MTD_FROM_FIXED_PARTITION(PROSPECTOR_RESOURCE_PARTITION));
+
+static bool ready;
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK_INSTALL)
+static const uint8_t pack_image[] = {
+#include "prospector_resources.inc"
+};
+#endif
+
+bool prospector_resources_ready(void) { return ready; }
+
+static bool resources_valid(void) {
+    struct resource_pack_header header;
+
+    memcpy(&header, (const void *)PROSPECTOR_RESOURCE_XIP_BASE, sizeof(header));
+    if (header.magic != RESOURCE_PACK_MAGIC) {
+        LOG_ERR("No resource pack in QSPI flash");
+        return false;
+    }
+
+    if (header.version != PROSPECTOR_RESOURCE_PACK_VERSION ||
+        header.size != PROSPECTOR_RESOURCE_PACK_SIZE || header.crc != PROSPECTOR_RESOURCE_PACK_CRC) {
+        LOG_ERR("Resource pack %08x does not match this firmware's %08x", header.crc,
+                PROSPECTOR_RESOURCE_PACK_CRC);
+        return false;
+    }
+
+    // The header can match a pack that was only partly written
+    if (crc32_ieee(PROSPECTOR_RESOURCE(0), header.size) != header.crc) {
+        LOG_ERR("Resource pack is corrupt");
+        return false;
+    }
+
+    return true;
+}
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK_INSTALL)
+static int resources_install(void) {
+    const struct flash_area *fa;
+    int ret;
+
+    ret = flash_area_open(FIXED_PARTITION_ID(prospector_resources_partition), &fa);
+    if (ret) {
+        return ret;
+    }
+
+    LOG_INF("Writing %u byte resource pack to QSPI flash", sizeof(pack_image));
+
+    // Flash erases in 4 KiB sectors
+    ret = flash_area_erase(fa, 0, ROUND_UP(sizeof(pack_image), 4096));
+    if (!ret) {
+        ret = flash_area_write(fa, 0, pack_image, sizeof(pack_image));
+    }
+
+    flash_area_close(fa);
+    return ret;
+}
+#endif
+
+static int resources_init(void) {
+    if (!device_is_ready(flash_dev)) {
+        LOG_ERR("QSPI flash not ready");
+        return -ENODEV;
+    }
+
+    nrf_qspi_nor_xip_enable(flash_dev, true);
+
+    ready = resources_valid();
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RESOURCE_PACK_INSTALL)
+    if (!ready) {
+        int ret = resources_install();
+        if (ret) {
+            LOG_ERR("Failed to write resource pack (%d)", ret);
+            return ret;
+        }
+        ready = resources_valid();
+    }
+#endif
+
+    if (ready) {
+        LOG_INF("Resource pack of %u bytes mapped at %p", PROSPECTOR_RESOURCE_PACK_SIZE,
+                PROSPECTOR_RESOURCE(0));
+    }
+
+    return ready ? 0 : -ENOENT;
+}
+
+// After the QSPI flash driver, before the display builds its screen
+SYS_INIT(resources_init, POST_KERNEL, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -1,4 +1,9 @@
 #include "battery_bar.h"
+#include "widget_listener.h"
+#include "render_profile.h"
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+#include "gradient_cache.h"
+#endif
 
 #include <zmk/display.h>
 #include <zmk/battery.h>
@@ -14,120 +19,226 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
-bool initialized = false;
-
-// Simplified state structures for each event type
+#define BATTERY_LOW_LEVEL 20
+// Not a percentage, so the first real report, 0% included, always renders
+#define BATTERY_LEVEL_UNKNOWN UINT8_MAX
+#define BATTERY_STATE_LOW LV_STATE_USER_1
+
+#define BATTERY_GRAD_FROM     0x909090
+#define BATTERY_GRAD_TO       0xf0f0f0
+#define BATTERY_GRAD_LOW_FROM 0xD3900F
+#define BATTERY_GRAD_LOW_TO   0xE8AC11
+
+// Shared by every slot; the low battery look is applied by toggling BATTERY_STATE_LOW
+static lv_style_t style_bar_main;
+static lv_style_t style_bar_main_low;
+static lv_style_t style_bar_indicator;
+static lv_style_t style_bar_indicator_low;
+static lv_style_t style_num;
+static lv_style_t style_num_low;
+static lv_style_t style_nc_bar;
+static lv_style_t style_nc_num;
+
+// Full snapshots of every slot, so coalesced events for different slots can't overwrite each other
 struct battery_update_state {
-    uint8_t source;
-    uint8_t level;
+    uint8_t level[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 };
 
 struct connection_update_state {
-    uint8_t source;
-    bool connected;
+    bool connected[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 };
 
-static void set_battery_bar_value(lv_obj_t *widget, struct battery_update_state state) {
-    if (initialized) {
-        lv_obj_t *info_container = lv_obj_get_child(widget, state.source);
-        lv_obj_t *bar = lv_obj_get_child(info_container, 0);
-        lv_obj_t *num = lv_obj_get_child(info_container, 1);
+static void set_battery_bar_value(struct zmk_widget_battery_bar_slot *slot, uint8_t level) {
+    if (level == slot->level || level == BATTERY_LEVEL_UNKNOWN) {
+        return;
+    }
+    slot->level = level;
 
-        lv_bar_set_value(bar, state.level, LV_ANIM_ON);
-        lv_label_set_text_fmt(num, "%d", state.level);
+    lv_bar_set_value(slot->bar, level, LV_ANIM_ON);
+    snprintf(slot->num_text, sizeof(slot->num_text), "%d", level);
+    lv_label_set_text_static(slot->num, slot->num_text);
 
-        if (state.level < 20) {
-            lv_obj_set_style_bg_color(bar, lv_color_hex(0xD3900F), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_grad_color(bar, lv_color_hex(0xE8AC11), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_color(bar, lv_color_hex(0x6E4E07), LV_PART_MAIN);
-            lv_obj_set_style_text_color(num, lv_color_hex(0xFFB802), 0);
+    bool low = level < BATTERY_LOW_LEVEL;
+    if (low != lv_obj_has_state(slot->bar, BATTERY_STATE_LOW)) {
+        if (low) {
+            lv_obj_add_state(slot->bar, BATTERY_STATE_LOW);
+            lv_obj_add_state(slot->num, BATTERY_STATE_LOW);
         } else {
-            lv_obj_set_style_bg_color(bar, lv_color_hex(0x909090), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_grad_color(bar, lv_color_hex(0xf0f0f0), LV_PART_INDICATOR);
-            lv_obj_set_style_bg_color(bar, lv_color_hex(0x202020), LV_PART_MAIN);
-            lv_obj_set_style_text_color(num, lv_color_hex(0xFFFFFF), 0);
+            lv_obj_clear_state(slot->bar, BATTERY_STATE_LOW);
+            lv_obj_clear_state(slot->num, BATTERY_STATE_LOW);
         }
     }
 }
 
-static void set_battery_bar_connected(lv_obj_t *widget, struct connection_update_state state) {
-    if (initialized) {
-        lv_obj_t *info_container = lv_obj_get_child(widget, state.source);
-        lv_obj_t *bar = lv_obj_get_child(info_container, 0);
-        lv_obj_t *num = lv_obj_get_child(info_container, 1);
-        lv_obj_t *nc_bar = lv_obj_get_child(info_container, 2);
-        lv_obj_t *nc_num = lv_obj_get_child(info_container, 3);
-
-        LOG_DBG("Peripheral %d %s", state.source,
-                state.connected ? "connected" : "disconnected");
-
-        if (state.connected) {
-            lv_obj_fade_out(nc_bar, 150, 0);
-            lv_obj_fade_out(nc_num, 150, 0);
-            lv_obj_fade_in(bar, 150, 250);
-            lv_obj_fade_in(num, 150, 250);
-        } else {
-            lv_obj_fade_out(bar, 150, 0);
-            lv_obj_fade_out(num, 150, 0);
-            lv_obj_fade_in(nc_bar, 150, 250);
-            lv_obj_fade_in(nc_num, 150, 250);
-        }
+static void set_battery_bar_connected(struct zmk_widget_battery_bar_slot *slot, bool connected) {
+    if (connected == slot->connected) {
+        return;
+    }
+    slot->connected = connected;
+
+    lv_obj_t *show[] = {connected ? slot->bar : slot->nc_bar, connected ? slot->num : slot->nc_num};
+    lv_obj_t *hide[] = {connected ? slot->nc_bar : slot->bar, connected ? slot->nc_num : slot->num};
+
+    for (int i = 0; i < ARRAY_SIZE(show); i++) {
+#if PROSPECTOR_FADES
+        lv_obj_fade_out(hide[i], PROSPECTOR_ANIM_MS(150), 0);
+        lv_obj_fade_in(show[i], PROSPECTOR_ANIM_MS(150), PROSPECTOR_ANIM_MS(250));
+#else
+        lv_obj_set_style_opa(hide[i], LV_OPA_TRANSP, 0);
+        lv_obj_set_style_opa(show[i], LV_OPA_COVER, 0);
+#endif
     }
 }
 
 // Battery event handling
 void battery_bar_battery_update_cb(struct battery_update_state state) {
-    LOG_DBG("Battery update: source=%d, level=%d", state.source, state.level);
-
     struct zmk_widget_battery_bar *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
-        set_battery_bar_value(widget->obj, state);
+        for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+            set_battery_bar_value(&widget->slots[i], state.level[i]);
+        }
     }
 }
 
 static struct battery_update_state battery_bar_get_battery_state(const zmk_event_t *eh) {
+    static struct battery_update_state state = {
+        .level = {[0 ... ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1] = BATTERY_LEVEL_UNKNOWN},
+    };
+
     const struct zmk_peripheral_battery_state_changed *bat_ev =
-        as_zmk_peripheral_battery_state_changed(eh);
+        eh != NULL ? as_zmk_peripheral_battery_state_changed(eh) : NULL;
 
-    LOG_DBG("Received battery event: source=%d, level=%d", bat_ev->source, bat_ev->state_of_charge);
+    if (bat_ev != NULL && bat_ev->source < ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        LOG_DBG("Received battery event: source=%d, level=%d", bat_ev->source,
+                bat_ev->state_of_charge);
+        state.level[bat_ev->source] = bat_ev->state_of_charge;
+    }
 
-    return (struct battery_update_state){
-        .source = bat_ev->source,
-        .level = bat_ev->state_of_charge,
-    };
+    return state;
 }
 
 // Connection event handling
 void battery_bar_connection_update_cb(struct connection_update_state state) {
-    LOG_DBG("Connection update: source=%d, connected=%s", state.source, state.connected ? "true" : "false");
-
     struct zmk_widget_battery_bar *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
-        set_battery_bar_connected(widget->obj, state);
+        for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+            set_battery_bar_connected(&widget->slots[i], state.connected[i]);
+        }
     }
 }
 
 static struct connection_update_state battery_bar_get_connection_state(const zmk_event_t *eh) {
+    static struct connection_update_state state;
+
     const struct zmk_split_central_status_changed *conn_ev =
-        as_zmk_split_central_status_changed(eh);
+        eh != NULL ? as_zmk_split_central_status_changed(eh) : NULL;
 
-    LOG_DBG("Received connection event: slot=%d, connected=%s", conn_ev->slot, conn_ev->connected ? "true" : "false");
+    if (conn_ev != NULL && conn_ev->slot < ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        LOG_DBG("Received connection event: slot=%d, connected=%s", conn_ev->slot,
+                conn_ev->connected ? "true" : "false");
+        state.connected[conn_ev->slot] = conn_ev->connected;
+    }
 
-    return (struct connection_update_state){
-        .source = conn_ev->slot,
-        .connected = conn_ev->connected,
-    };
+    return state;
 }
 
 // Separate widget listeners for each event type
-ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_bar_battery, struct battery_update_state,
-                            battery_bar_battery_update_cb, battery_bar_get_battery_state);
+PROSPECTOR_WIDGET_LISTENER(widget_battery_bar_battery, struct battery_update_state,
+                           battery_bar_battery_update_cb, battery_bar_get_battery_state);
 ZMK_SUBSCRIPTION(widget_battery_bar_battery, zmk_peripheral_battery_state_changed);
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_bar_connection, struct connection_update_state,
-                            battery_bar_connection_update_cb, battery_bar_get_connection_state);
+PROSPECTOR_WIDGET_LISTENER(widget_battery_bar_connection, struct connection_update_state,
+                           battery_bar_connection_update_cb, battery_bar_get_connection_state);
 ZMK_SUBSCRIPTION(widget_battery_bar_connection, zmk_split_central_status_changed);
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+/*
+ * lv_bar spans the indicator gradient over the whole bar, so a full width
+ * image tiled from the bar's left edge and clipped to the fill looks the same.
+ * Without a free cache entry the bar keeps the flat indicator color.
+ */
+static void battery_bar_gradient_event_cb(lv_event_t *e) {
+    struct zmk_widget_battery_bar_slot *slot = lv_event_get_user_data(e);
+
+    gradient_cache_release(slot->grad);
+    gradient_cache_release(slot->grad_low);
+    slot->grad = NULL;
+    slot->grad_low = NULL;
+
+    if (lv_event_get_code(e) == LV_EVENT_DELETE) {
+        return;
+    }
+
+    lv_coord_t width = lv_obj_get_width(slot->bar);
+    slot->grad = gradient_cache_get(width, BATTERY_GRAD_FROM, BATTERY_GRAD_TO);
+    slot->grad_low = gradient_cache_get(width, BATTERY_GRAD_LOW_FROM, BATTERY_GRAD_LOW_TO);
+
+    lv_obj_set_style_bg_img_src(slot->bar, slot->grad, LV_PART_INDICATOR);
+    lv_obj_set_style_bg_img_src(slot->bar, slot->grad_low, LV_PART_INDICATOR | BATTERY_STATE_LOW);
+}
+#endif
+
+static void battery_bar_init_styles(void) {
+    static bool styles_initialized = false;
+    if (styles_initialized) {
+        return;
+    }
+
+    lv_style_init(&style_bar_main);
+    lv_style_set_bg_color(&style_bar_main, lv_color_hex(0x202020));
+    lv_style_set_bg_opa(&style_bar_main, LV_OPA_COVER);
+    lv_style_set_radius(&style_bar_main, 1);
+    lv_style_set_anim_time(&style_bar_main, PROSPECTOR_ANIM_MS(250));
+
+    lv_style_init(&style_bar_main_low);
+    lv_style_set_bg_color(&style_bar_main_low, lv_color_hex(0x6E4E07));
+
+    lv_style_init(&style_bar_indicator);
+    lv_style_set_bg_opa(&style_bar_indicator, LV_OPA_COVER);
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+    // The gradient itself is a tiled background image set per bar once its width is known
+    lv_style_set_bg_color(&style_bar_indicator, lv_color_hex(BATTERY_GRAD_FROM));
+    lv_style_set_bg_img_tiled(&style_bar_indicator, true);
+#elif PROSPECTOR_BAR_GRADIENT
+    lv_style_set_bg_color(&style_bar_indicator, lv_color_hex(BATTERY_GRAD_FROM));
+    lv_style_set_bg_grad_color(&style_bar_indicator, lv_color_hex(BATTERY_GRAD_TO));
+    lv_style_set_bg_dither_mode(&style_bar_indicator, PROSPECTOR_BAR_DITHER);
+    lv_style_set_bg_grad_dir(&style_bar_indicator, LV_GRAD_DIR_HOR);
+#else
+    // Flat fill at the gradient's midpoint
+    lv_style_set_bg_color(&style_bar_indicator, lv_color_hex(0xc0c0c0));
+#endif
+    lv_style_set_radius(&style_bar_indicator, 1);
+    lv_style_set_opa(&style_bar_indicator, LV_OPA_COVER);
+
+    lv_style_init(&style_bar_indicator_low);
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+    lv_style_set_bg_color(&style_bar_indicator_low, lv_color_hex(BATTERY_GRAD_LOW_FROM));
+#elif PROSPECTOR_BAR_GRADIENT
+    lv_style_set_bg_color(&style_bar_indicator_low, lv_color_hex(BATTERY_GRAD_LOW_FROM));
+    lv_style_set_bg_grad_color(&style_bar_indicator_low, lv_color_hex(BATTERY_GRAD_LOW_TO));
+#else
+    lv_style_set_bg_color(&style_bar_indicator_low, lv_color_hex(0xDE9E10));
+#endif
+
+    lv_style_init(&style_num);
+    lv_style_set_text_font(&style_num, &FoundryGridnikMedium_20);
+    lv_style_set_text_color(&style_num, lv_color_white());
+
+    lv_style_init(&style_num_low);
+    lv_style_set_text_color(&style_num_low, lv_color_hex(0xFFB802));
+
+    lv_style_init(&style_nc_bar);
+    lv_style_set_bg_color(&style_nc_bar, lv_color_hex(0x9e2121));
+    lv_style_set_bg_opa(&style_nc_bar, LV_OPA_COVER);
+    lv_style_set_radius(&style_nc_bar, 1);
+
+    lv_style_init(&style_nc_num);
+    lv_style_set_text_color(&style_nc_num, lv_color_hex(0xe63030));
+
+    styles_initialized = true;
+}
+
 int zmk_widget_battery_bar_init(struct zmk_widget_battery_bar *widget, lv_obj_t *parent) {
     widget->obj = lv_obj_create(parent);
     lv_obj_set_width(widget->obj, lv_pct(100));
@@ -145,60 +256,65 @@ int zmk_widget_battery_bar_init(struct zmk_widget_battery_bar *widget, lv_obj_t
 
     // lv_obj_add_flag(widget->obj, LV_OBJ_FLAG_OVERFLOW_VISIBLE);
 
+    battery_bar_init_styles();
+
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        struct zmk_widget_battery_bar_slot *slot = &widget->slots[i];
+        slot->level = BATTERY_LEVEL_UNKNOWN;
+        slot->connected = false;
+
         lv_obj_t *info_container = lv_obj_create(widget->obj);
         lv_obj_center(info_container);
         lv_obj_set_height(info_container, lv_pct(100));
         lv_obj_set_flex_grow(info_container, 1);
 
-        lv_obj_t *bar = lv_bar_create(info_container);
-        lv_obj_set_size(bar, lv_pct(100), 4);
-        lv_obj_align(bar, LV_ALIGN_BOTTOM_MID, 0, 0);
-        lv_obj_set_style_bg_color(bar, lv_color_hex(0x202020), LV_PART_MAIN);
-        lv_obj_set_style_bg_opa(bar, 255, LV_PART_MAIN);
-        lv_obj_set_style_radius(bar, 1, LV_PART_MAIN);
-        lv_obj_set_style_bg_color(bar, lv_color_hex(0x909090), LV_PART_INDICATOR);
-        lv_obj_set_style_bg_opa(bar, 255, LV_PART_INDICATOR);
-        lv_obj_set_style_bg_grad_color(bar, lv_color_hex(0xf0f0f0), LV_PART_INDICATOR);
-        lv_obj_set_style_bg_dither_mode(bar, LV_DITHER_ERR_DIFF, LV_PART_INDICATOR);
-        lv_obj_set_style_bg_grad_dir(bar, LV_GRAD_DIR_HOR, LV_PART_INDICATOR);
-        lv_obj_set_style_radius(bar, 1, LV_PART_INDICATOR);
-        lv_obj_set_style_anim_time(bar, 250, 0);
-
-        lv_bar_set_value(bar, 0, LV_ANIM_OFF);
-        lv_obj_set_style_opa(bar, 0, LV_PART_MAIN);
-        lv_obj_set_style_opa(bar, 255, LV_PART_INDICATOR);
-
-        lv_obj_t *num = lv_label_create(info_container);
-        lv_obj_set_style_text_font(num, &FoundryGridnikMedium_20, 0);
-        lv_obj_set_style_text_color(num, lv_color_white(), 0);
-        lv_obj_set_style_opa(num, 255, 0);
-        lv_obj_align(num, LV_ALIGN_CENTER, 0, 0);
-        lv_label_set_text(num, "N/A");
-
-        lv_obj_set_style_opa(num, 0, 0);
-
-        lv_obj_t *nc_bar = lv_obj_create(info_container);
-        lv_obj_set_size(nc_bar, lv_pct(100), 4);
-        lv_obj_align(nc_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
-        lv_obj_set_style_bg_color(nc_bar, lv_color_hex(0x9e2121), LV_PART_MAIN);
-        lv_obj_set_style_radius(nc_bar, 1, LV_PART_MAIN);
-        lv_obj_set_style_bg_opa(nc_bar, 255, 0);
-
-        lv_obj_t *nc_num = lv_label_create(info_container);
-        lv_obj_set_style_text_color(nc_num, lv_color_hex(0xe63030), 0);
-        lv_obj_align(nc_num, LV_ALIGN_CENTER, 0, 0);
-        lv_label_set_text(nc_num, LV_SYMBOL_CLOSE);
-        lv_obj_set_style_opa(nc_num, 255, 0);
+        slot->bar = lv_bar_create(info_container);
+        lv_obj_add_style(slot->bar, &style_bar_main, LV_PART_MAIN);
+        lv_obj_add_style(slot->bar, &style_bar_main_low, LV_PART_MAIN | BATTERY_STATE_LOW);
+        lv_obj_add_style(slot->bar, &style_bar_indicator, LV_PART_INDICATOR);
+        lv_obj_add_style(slot->bar, &style_bar_indicator_low,
+                         LV_PART_INDICATOR | BATTERY_STATE_LOW);
+        lv_obj_set_size(slot->bar, lv_pct(100), 4);
+        lv_obj_align(slot->bar, LV_ALIGN_BOTTOM_MID, 0, 0);
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+        slot->grad = NULL;
+        slot->grad_low = NULL;
+        lv_obj_add_event_cb(slot->bar, battery_bar_gradient_event_cb, LV_EVENT_SIZE_CHANGED,
+                            slot);
+        lv_obj_add_event_cb(slot->bar, battery_bar_gradient_event_cb, LV_EVENT_DELETE, slot);
+#endif
+
+        lv_bar_set_value(slot->bar, 0, LV_ANIM_OFF);
+        lv_obj_set_style_opa(slot->bar, 0, LV_PART_MAIN);
+
+        slot->num = lv_label_create(info_container);
+        lv_obj_add_style(slot->num, &style_num, 0);
+        lv_obj_add_style(slot->num, &style_num_low, BATTERY_STATE_LOW);
+        lv_obj_align(slot->num, LV_ALIGN_CENTER, 0, 0);
+        lv_label_set_text_static(slot->num, "N/A");
+        lv_obj_set_style_opa(slot->num, 0, 0);
+
+        slot->nc_bar = lv_obj_create(info_container);
+        lv_obj_add_style(slot->nc_bar, &style_nc_bar, LV_PART_MAIN);
+        lv_obj_set_size(slot->nc_bar, lv_pct(100), 4);
+        lv_obj_align(slot->nc_bar, LV_ALIGN_BOTTOM_MID, 0, 0);
+
+        slot->nc_num = lv_label_create(info_container);
+        lv_obj_add_style(slot->nc_num, &style_nc_num, 0);
+        lv_obj_align(slot->nc_num, LV_ALIGN_CENTER, 0, 0);
+        lv_label_set_text_static(slot->nc_num, LV_SYMBOL_CLOSE);
     }
 
     sys_slist_append(&widgets, &widget->node);
 
     widget_battery_bar_battery_init();
     widget_battery_bar_connection_init();
-    initialized = true;
 
     return 0;
 }
 
+void zmk_widget_battery_bar_deinit(struct zmk_widget_battery_bar *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+}
+
 lv_obj_t *zmk_widget_battery_bar_obj(struct zmk_widget_battery_bar *widget) { return widget->obj; }
\ No newline at end of file
@@ -2,11 +2,30 @@
 
 #include <lvgl.h>
 #include <zephyr/kernel.h>
+#include <zmk/ble.h>
+
+struct zmk_widget_battery_bar_slot {
+    lv_obj_t *bar;
+    lv_obj_t *num;
+    lv_obj_t *nc_bar;
+    lv_obj_t *nc_num;
+    char num_text[4];
+    uint8_t level;
+    bool connected;
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+    // Gradient cache references held by the bar, released when it resizes or is deleted
+    const lv_img_dsc_t *grad;
+    const lv_img_dsc_t *grad_low;
+#endif
+};
 
 struct zmk_widget_battery_bar {
     sys_snode_t node;
     lv_obj_t *obj;
+    struct zmk_widget_battery_bar_slot slots[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 };
 
 int zmk_widget_battery_bar_init(struct zmk_widget_battery_bar *widget, lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_battery_bar_deinit(struct zmk_widget_battery_bar *widget);
 lv_obj_t *zmk_widget_battery_bar_obj(struct zmk_widget_battery_bar *widget);
\ No newline at end of file
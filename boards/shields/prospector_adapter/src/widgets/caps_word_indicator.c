@@ -1,4 +1,5 @@
 #include "caps_word_indicator.h"
+#include "widget_listener.h"
 
 #include <zmk/display.h>
 #include <zmk/events/caps_word_state_changed.h>
@@ -32,15 +33,19 @@ static void caps_word_indicator_update_cb(struct caps_word_indicator_state state
 }
 
 static struct caps_word_indicator_state caps_word_indicator_get_state(const zmk_event_t *eh) {
+    static struct caps_word_indicator_state state;
+
     const struct zmk_caps_word_state_changed *ev =
-        as_zmk_caps_word_state_changed(eh);
-    LOG_INF("DISP | Caps Word State Changed: %d", ev->active);
-    return (struct caps_word_indicator_state){
-        .active = ev->active,
-    };
+        eh != NULL ? as_zmk_caps_word_state_changed(eh) : NULL;
+    if (ev != NULL) {
+        LOG_INF("DISP | Caps Word State Changed: %d", ev->active);
+        state.active = ev->active;
+    }
+
+    return state;
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_caps_word_indicator, struct caps_word_indicator_state,
+PROSPECTOR_WIDGET_LISTENER(widget_caps_word_indicator, struct caps_word_indicator_state,
                             caps_word_indicator_update_cb, caps_word_indicator_get_state)
 ZMK_SUBSCRIPTION(widget_caps_word_indicator, zmk_caps_word_state_changed);
 
@@ -61,6 +66,10 @@ int zmk_widget_caps_word_indicator_init(struct zmk_widget_caps_word_indicator *w
     return 0;
 }
 
+void zmk_widget_caps_word_indicator_deinit(struct zmk_widget_caps_word_indicator *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+}
+
 lv_obj_t *zmk_widget_caps_word_indicator_obj(struct zmk_widget_caps_word_indicator *widget) {
     return widget->obj;
 }
\ No newline at end of file
@@ -9,4 +9,6 @@ struct zmk_widget_caps_word_indicator {
 };
 
 int zmk_widget_caps_word_indicator_init(struct zmk_widget_caps_word_indicator *widget, lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_caps_word_indicator_deinit(struct zmk_widget_caps_word_indicator *widget);
 lv_obj_t *zmk_widget_caps_word_indicator_obj(struct zmk_widget_caps_word_indicator *widget);
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "fade_overlay.h"
+
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Tiles are repeated horizontally by lv_img, so only a narrow strip is stored
+#define FADE_TILE_W     8
+#define FADE_MAX_BAND_H 64
+
+#define FADE_TILE_SIZE (FADE_TILE_W * FADE_MAX_BAND_H * LV_IMG_PX_SIZE_ALPHA_BYTE)
+
+static uint8_t fade_top_buf[FADE_TILE_SIZE];
+static uint8_t fade_bottom_buf[FADE_TILE_SIZE];
+
+static lv_img_dsc_t fade_top_img = {
+    .header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA,
+    .header.w = FADE_TILE_W,
+    .data = fade_top_buf,
+};
+
+static lv_img_dsc_t fade_bottom_img = {
+    .header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA,
+    .header.w = FADE_TILE_W,
+    .data = fade_bottom_buf,
+};
+
+static lv_coord_t fade_band_h = 0;
+
+// Black with a per-row alpha; alpha 0 at the inner edge, opaque at the outer edge
+static void fade_render_tile(uint8_t *buf, lv_coord_t band_h, bool top) {
+    lv_color_t black = lv_color_black();
+
+    for (lv_coord_t y = 0; y < band_h; y++) {
+        lv_opa_t visible = (lv_opa_t)((LV_OPA_COVER * y) / MAX(band_h - 1, 1));
+        lv_opa_t alpha = top ? LV_OPA_COVER - visible : visible;
+        uint8_t *px = &buf[y * FADE_TILE_W * LV_IMG_PX_SIZE_ALPHA_BYTE];
+
+        for (int x = 0; x < FADE_TILE_W; x++) {
+            memcpy(px, &black, sizeof(black));
+            px[LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = alpha;
+            px += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        }
+    }
+}
+
+static void fade_render(lv_coord_t band_h) {
+    if (band_h == fade_band_h) {
+        return;
+    }
+
+    fade_render_tile(fade_top_buf, band_h, true);
+    fade_render_tile(fade_bottom_buf, band_h, false);
+
+    fade_top_img.header.h = band_h;
+    fade_top_img.data_size = band_h * FADE_TILE_W * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    fade_bottom_img.header.h = band_h;
+    fade_bottom_img.data_size = fade_top_img.data_size;
+
+    fade_band_h = band_h;
+    lv_img_cache_invalidate_src(&fade_top_img);
+    lv_img_cache_invalidate_src(&fade_bottom_img);
+}
+
+static lv_obj_t *fade_band_create(lv_obj_t *parent, const lv_img_dsc_t *src, lv_align_t align) {
+    lv_obj_t *band = lv_img_create(parent);
+
+    lv_img_set_src(band, src);
+    lv_obj_set_width(band, lv_pct(100));
+    lv_obj_align(band, align, 0, 0);
+    lv_obj_add_flag(band, LV_OBJ_FLAG_IGNORE_LAYOUT);
+    lv_obj_clear_flag(band, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+    return band;
+}
+
+void fade_overlay_create(struct fade_overlay *overlay, lv_obj_t *parent) {
+    overlay->top = fade_band_create(parent, &fade_top_img, LV_ALIGN_TOP_MID);
+    overlay->bottom = fade_band_create(parent, &fade_bottom_img, LV_ALIGN_BOTTOM_MID);
+}
+
+void fade_overlay_set_band_height(struct fade_overlay *overlay, lv_coord_t band_h) {
+    band_h = CLAMP(band_h, 1, FADE_MAX_BAND_H);
+
+    fade_render(band_h);
+
+    lv_obj_set_height(overlay->top, band_h);
+    lv_obj_set_height(overlay->bottom, band_h);
+    lv_img_set_src(overlay->top, &fade_top_img);
+    lv_img_set_src(overlay->bottom, &fade_bottom_img);
+}
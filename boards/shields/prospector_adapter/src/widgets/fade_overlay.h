@@ -0,0 +1,22 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Pre-rendered replacement for lv_draw_mask_fade: a pair of image objects that
+ * darken the top and bottom of their parent towards black. The gradients are
+ * rendered once into small tiles, so the parent's content draws unmasked and
+ * only the band area is blended on redraw.
+ */
+struct fade_overlay {
+    lv_obj_t *top;
+    lv_obj_t *bottom;
+};
+
+void fade_overlay_create(struct fade_overlay *overlay, lv_obj_t *parent);
+
+/*
+ * Set the height of both bands. All overlays share the same tiles, so the most
+ * recent height wins for every instance.
+ */
+void fade_overlay_set_band_height(struct fade_overlay *overlay, lv_coord_t band_h);
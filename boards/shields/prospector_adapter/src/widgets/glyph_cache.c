@@ -0,0 +1,186 @@
+#include "glyph_cache.h"
+
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if CONFIG_PROSPECTOR_GLYPH_CACHE_SIZE == 0
+#if !__has_include(<glyph_cache_size.h>)
+#error "CONFIG_PROSPECTOR_GLYPH_CACHE_SIZE=0 takes the size from CONFIG_PROSPECTOR_FONT_SUBSET"
+#endif
+// Written by subset_fonts.py, room for every layer name glyph at once
+#include <glyph_cache_size.h>
+#define GLYPH_ARENA_BYTES MAX(PROSPECTOR_LAYER_GLYPH_BYTES, 1)
+#define GLYPH_ENTRIES     MAX(PROSPECTOR_LAYER_GLYPHS, 64)
+#else
+#define GLYPH_ARENA_BYTES CONFIG_PROSPECTOR_GLYPH_CACHE_SIZE
+#define GLYPH_ENTRIES     64
+#endif
+
+// Glyphs are allocated by size from one arena; the entry table bounds how many it holds
+#define GLYPH_FONTS        4
+#define GLYPH_REPORT_EVERY 1024
+
+struct glyph_entry {
+    const lv_font_t *base;
+    uint32_t letter;
+    uint32_t last_used;
+    uint32_t offset;
+    uint32_t size;
+};
+
+// Kept in arena order, so the arena is compacted by sliding entries down
+static struct glyph_entry entries[GLYPH_ENTRIES];
+static int entry_count;
+static uint8_t arena[GLYPH_ARENA_BYTES] __aligned(4);
+// End of the last allocation, and the bytes still held by glyphs below it
+static uint32_t arena_used;
+static uint32_t cached_bytes;
+static lv_font_t fonts[GLYPH_FONTS];
+static uint32_t use_counter;
+static uint32_t hits;
+static uint32_t misses;
+
+static const lv_font_t *glyph_base(const lv_font_t *font) { return font->dsc; }
+
+static bool glyph_fits(const lv_font_glyph_dsc_t *dsc) {
+    return (dsc->bpp == 1 || dsc->bpp == 2 || dsc->bpp == 4) &&
+           dsc->box_w * dsc->box_h <= GLYPH_ARENA_BYTES;
+}
+
+static bool glyph_cache_get_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter,
+                                uint32_t letter_next) {
+    const lv_font_t *base = glyph_base(font);
+
+    if (!base->get_glyph_dsc(base, dsc, letter, letter_next)) {
+        return false;
+    }
+
+    if (glyph_fits(dsc)) {
+        dsc->bpp = 8;
+    }
+    return true;
+}
+
+static void glyph_report(void) {
+    if ((hits + misses) % GLYPH_REPORT_EVERY == 0) {
+        LOG_INF("Glyph cache: %u hits, %u misses (%u%% hit rate), %d glyphs in %u of %u bytes",
+                hits, misses, hits * 100 / (hits + misses), entry_count, cached_bytes,
+                GLYPH_ARENA_BYTES);
+    }
+}
+
+// Glyph rows are packed back to back, most significant bits first
+static void glyph_expand(uint8_t *dst, const uint8_t *src, uint32_t px, uint8_t bpp) {
+    uint8_t max = BIT(bpp) - 1;
+
+    for (uint32_t i = 0; i < px; i++) {
+        uint32_t bit = i * bpp;
+        uint8_t value = (src[bit >> 3] >> (8 - bpp - (bit & 7))) & max;
+        dst[i] = value * 255 / max;
+    }
+}
+
+static void glyph_evict_lru(void) {
+    int victim = 0;
+
+    for (int i = 1; i < entry_count; i++) {
+        if (entries[i].last_used < entries[victim].last_used) {
+            victim = i;
+        }
+    }
+
+    cached_bytes -= entries[victim].size;
+    memmove(&entries[victim], &entries[victim + 1],
+            (entry_count - victim - 1) * sizeof(entries[0]));
+    entry_count--;
+}
+
+// Slides the remaining glyphs to the start of the arena, leaving the free space at the end
+static void glyph_compact(void) {
+    arena_used = 0;
+
+    for (int i = 0; i < entry_count; i++) {
+        if (entries[i].offset != arena_used) {
+            memmove(&arena[arena_used], &arena[entries[i].offset], entries[i].size);
+            entries[i].offset = arena_used;
+        }
+        arena_used += entries[i].size;
+    }
+}
+
+/*
+ * Evicts least recently used glyphs until size bytes and an entry are free.
+ * Bitmaps handed out earlier may move; LVGL draws each glyph before asking
+ * for the next.
+ */
+static struct glyph_entry *glyph_alloc(uint32_t size) {
+    while (entry_count == GLYPH_ENTRIES || GLYPH_ARENA_BYTES - cached_bytes < size) {
+        glyph_evict_lru();
+    }
+
+    if (GLYPH_ARENA_BYTES - arena_used < size) {
+        glyph_compact();
+    }
+
+    struct glyph_entry *entry = &entries[entry_count++];
+    entry->offset = arena_used;
+    entry->size = size;
+    arena_used += size;
+    cached_bytes += size;
+
+    return entry;
+}
+
+static const uint8_t *glyph_cache_get_bitmap(const lv_font_t *font, uint32_t letter) {
+    const lv_font_t *base = glyph_base(font);
+
+    use_counter++;
+
+    for (int i = 0; i < entry_count; i++) {
+        if (entries[i].base == base && entries[i].letter == letter) {
+            entries[i].last_used = use_counter;
+            hits++;
+            glyph_report();
+            return &arena[entries[i].offset];
+        }
+    }
+
+    lv_font_glyph_dsc_t dsc;
+    const uint8_t *bitmap = base->get_glyph_bitmap(base, letter);
+    if (bitmap == NULL || !base->get_glyph_dsc(base, &dsc, letter, 0) || !glyph_fits(&dsc)) {
+        return bitmap;
+    }
+
+    misses++;
+    glyph_report();
+
+    struct glyph_entry *entry = glyph_alloc(dsc.box_w * dsc.box_h);
+    glyph_expand(&arena[entry->offset], bitmap, entry->size, dsc.bpp);
+    entry->base = base;
+    entry->letter = letter;
+    entry->last_used = use_counter;
+
+    return &arena[entry->offset];
+}
+
+const lv_font_t *glyph_cache_font(const lv_font_t *base) {
+    for (int i = 0; i < GLYPH_FONTS; i++) {
+        if (fonts[i].dsc == base) {
+            return &fonts[i];
+        }
+
+        if (fonts[i].dsc == NULL) {
+            fonts[i] = *base;
+            fonts[i].dsc = base;
+            fonts[i].get_glyph_dsc = glyph_cache_get_dsc;
+            fonts[i].get_glyph_bitmap = glyph_cache_get_bitmap;
+            return &fonts[i];
+        }
+    }
+
+    LOG_WRN("No room to cache another font");
+    return base;
+}
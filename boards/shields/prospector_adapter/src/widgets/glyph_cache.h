@@ -0,0 +1,19 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Returns a font with the metrics and glyphs of base, whose glyph bitmaps are
+ * served from a cache of pre-expanded 8-bit alpha. Drawing then reads one
+ * byte per pixel instead of unpacking and mapping packed 1, 2 or 4bpp pixels
+ * for every glyph on every frame. Each glyph takes one byte per pixel of its
+ * box, and the least recently used glyphs make room for new ones. Glyphs
+ * larger than the whole cache fall back to base.
+ *
+ * Without CONFIG_PROSPECTOR_GLYPH_CACHE, returns base unchanged.
+ */
+#if IS_ENABLED(CONFIG_PROSPECTOR_GLYPH_CACHE)
+const lv_font_t *glyph_cache_font(const lv_font_t *base);
+#else
+static inline const lv_font_t *glyph_cache_font(const lv_font_t *base) { return base; }
+#endif
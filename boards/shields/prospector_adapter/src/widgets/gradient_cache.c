@@ -0,0 +1,117 @@
+#include "gradient_cache.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define GRAD_ROWS    4
+#define GRAD_MAX_W   280
+#define GRAD_ENTRIES CONFIG_PROSPECTOR_GRADIENT_CACHE_ENTRIES
+
+static const uint8_t bayer_4x4[GRAD_ROWS][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5},
+};
+
+struct gradient_entry {
+    lv_img_dsc_t dsc;
+    lv_coord_t width;
+    uint32_t from_hex;
+    uint32_t to_hex;
+    uint32_t last_used;
+    // Objects still drawing this image; only unreferenced entries are evicted
+    uint8_t refs;
+    lv_color_t pixels[GRAD_ROWS * GRAD_MAX_W];
+};
+
+static struct gradient_entry entries[GRAD_ENTRIES];
+static uint32_t use_counter;
+
+// Adds the ordered dither threshold for a channel that keeps `bits` of its 8
+static uint8_t dither_channel(uint8_t value, uint8_t threshold, int bits) {
+    uint16_t step = 1 << (8 - bits);
+    uint16_t v = value + (threshold * step) / 16;
+    return MIN(v, 255) & ~(step - 1);
+}
+
+static void gradient_render(struct gradient_entry *entry) {
+    lv_color32_t from = {.full = entry->from_hex | 0xff000000};
+    lv_color32_t to = {.full = entry->to_hex | 0xff000000};
+    lv_coord_t span = MAX(entry->width - 1, 1);
+
+    for (int y = 0; y < GRAD_ROWS; y++) {
+        lv_color_t *row = &entry->pixels[y * entry->width];
+
+        for (int x = 0; x < entry->width; x++) {
+            uint8_t t = bayer_4x4[y][x & 3];
+            uint8_t r = from.ch.red + (to.ch.red - from.ch.red) * x / span;
+            uint8_t g = from.ch.green + (to.ch.green - from.ch.green) * x / span;
+            uint8_t b = from.ch.blue + (to.ch.blue - from.ch.blue) * x / span;
+
+            row[x] = lv_color_make(dither_channel(r, t, 5), dither_channel(g, t, 6),
+                                   dither_channel(b, t, 5));
+        }
+    }
+
+    entry->dsc = (lv_img_dsc_t){
+        .header.cf = LV_IMG_CF_TRUE_COLOR,
+        .header.w = entry->width,
+        .header.h = GRAD_ROWS,
+        .data_size = entry->width * GRAD_ROWS * sizeof(lv_color_t),
+        .data = (const uint8_t *)entry->pixels,
+    };
+}
+
+const lv_img_dsc_t *gradient_cache_get(lv_coord_t width, uint32_t from_hex, uint32_t to_hex) {
+    struct gradient_entry *victim = NULL;
+
+    if (width <= 0 || width > GRAD_MAX_W) {
+        return NULL;
+    }
+
+    use_counter++;
+
+    for (int i = 0; i < GRAD_ENTRIES; i++) {
+        struct gradient_entry *entry = &entries[i];
+        if (entry->width == width && entry->from_hex == from_hex && entry->to_hex == to_hex) {
+            entry->last_used = use_counter;
+            entry->refs++;
+            return &entry->dsc;
+        }
+
+        if (entry->refs == 0 && (victim == NULL || entry->last_used < victim->last_used)) {
+            victim = entry;
+        }
+    }
+
+    if (victim == NULL) {
+        LOG_WRN("All %d gradient cache entries in use, drawing %d px gradient flat",
+                GRAD_ENTRIES, width);
+        return NULL;
+    }
+
+    LOG_DBG("Rendering %d px gradient %06x-%06x", width, from_hex, to_hex);
+    victim->width = width;
+    victim->from_hex = from_hex;
+    victim->to_hex = to_hex;
+    victim->last_used = use_counter;
+    victim->refs = 1;
+    gradient_render(victim);
+    lv_img_cache_invalidate_src(&victim->dsc);
+
+    return &victim->dsc;
+}
+
+void gradient_cache_release(const lv_img_dsc_t *img) {
+    if (img == NULL) {
+        return;
+    }
+
+    struct gradient_entry *entry = CONTAINER_OF(img, struct gradient_entry, dsc);
+    __ASSERT(entry->refs > 0, "Gradient released more often than taken");
+    entry->refs--;
+}
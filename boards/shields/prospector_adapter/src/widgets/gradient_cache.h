@@ -0,0 +1,18 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Horizontal gradients pre-rendered with 4x4 ordered dithering. The image is
+ * one dither period tall, meant to be tiled over an area as a background
+ * image, so drawing a gradient costs an image blit instead of per-pixel color
+ * interpolation and dithering on every redraw.
+ *
+ * The returned image holds a reference that keeps it from being evicted until
+ * gradient_cache_release(). Returns NULL if width is zero, wider than the
+ * cache supports, or every entry is still referenced.
+ */
+const lv_img_dsc_t *gradient_cache_get(lv_coord_t width, uint32_t from_hex, uint32_t to_hex);
+
+// Drops a reference taken by gradient_cache_get(); NULL is ignored
+void gradient_cache_release(const lv_img_dsc_t *img);
@@ -0,0 +1,216 @@
+#include "layer_carousel.h"
+#include "widget_listener.h"
+#include "layer_names.h"
+#include "render_profile.h"
+#include "glyph_cache.h"
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_NAME_IMAGES)
+#include "layer_images.h"
+#endif
+
+#include <zmk/display.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/event_manager.h>
+#include <zmk/keymap.h>
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+#include <zmk/studio/rpc.h>
+#endif
+
+#include <fonts.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Matches the line spacing the default theme gives lv_roller
+#define CAROUSEL_LINE_SPACE LV_DPX(20)
+#define CAROUSEL_ANIM_MS    PROSPECTOR_ANIM_MS(100)
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+struct layer_carousel_state {
+    uint8_t index;
+    // Bumped by keymap edits so the names get checked for changes
+    uint8_t keymap_version;
+};
+
+static lv_coord_t carousel_row_pitch(void) {
+    return lv_font_get_line_height(&FRAC_Thin_48) + CAROUSEL_LINE_SPACE;
+}
+
+static uint8_t carousel_wrap(int index) {
+    return (index + ZMK_KEYMAP_LAYERS_LEN) % ZMK_KEYMAP_LAYERS_LEN;
+}
+
+// Only labels showing a different layer or a renamed one are re-measured
+static void carousel_set_name(struct zmk_widget_layer_carousel *widget,
+                              enum layer_carousel_slot slot, uint8_t index, uint32_t renamed) {
+    if (widget->slot_index[slot] == index && !(renamed & BIT(index))) {
+        return;
+    }
+
+    widget->slot_index[slot] = index;
+    lv_label_set_text_static(widget->labels[slot], layer_names_get(index));
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_NAME_IMAGES)
+    // Names without an image are left to the label
+    const lv_img_dsc_t *img = layer_images_get(index, slot == LAYER_CAROUSEL_CURRENT);
+
+    if (img != NULL) {
+        lv_img_set_src(widget->images[slot], img);
+        lv_obj_clear_flag(widget->images[slot], LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(widget->labels[slot], LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(widget->images[slot], LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(widget->labels[slot], LV_OBJ_FLAG_HIDDEN);
+    }
+#endif
+}
+
+static void carousel_anim_y_cb(void *var, int32_t v) {
+    lv_obj_set_style_translate_y(var, v, 0);
+}
+
+static void layer_carousel_set_index(struct zmk_widget_layer_carousel *widget, uint8_t index,
+                                     uint32_t renamed, bool animate) {
+    uint8_t previous = widget->index;
+
+    widget->index = index;
+    carousel_set_name(widget, LAYER_CAROUSEL_PREV, carousel_wrap(index - 1), renamed);
+    carousel_set_name(widget, LAYER_CAROUSEL_CURRENT, index, renamed);
+    carousel_set_name(widget, LAYER_CAROUSEL_NEXT, carousel_wrap(index + 1), renamed);
+
+    if (!animate || previous == index || CAROUSEL_ANIM_MS == 0) {
+        return;
+    }
+
+    // Scroll the short way round, like the infinite roller does
+    bool forward = carousel_wrap(index - previous) <= ZMK_KEYMAP_LAYERS_LEN / 2;
+    lv_coord_t pitch = carousel_row_pitch();
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, widget->strip);
+    lv_anim_set_exec_cb(&a, carousel_anim_y_cb);
+    lv_anim_set_values(&a, forward ? pitch : -pitch, 0);
+    lv_anim_set_time(&a, CAROUSEL_ANIM_MS);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    lv_anim_start(&a);
+}
+
+static void layer_carousel_update_cb(struct layer_carousel_state state) {
+    uint32_t renamed = layer_names_refresh();
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_NAME_IMAGES)
+    layer_images_drop(renamed);
+#endif
+
+    struct zmk_widget_layer_carousel *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        layer_carousel_set_index(widget, state.index, renamed, true);
+    }
+}
+
+static struct layer_carousel_state layer_carousel_get_state(const zmk_event_t *eh) {
+    static uint8_t keymap_version;
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+    if (eh != NULL && as_zmk_studio_rpc_notification(eh) != NULL) {
+        keymap_version++;
+    }
+#endif
+
+    uint8_t index = layer_names_index_of(zmk_keymap_highest_layer_active());
+    LOG_DBG("Carousel set to: %d", index);
+    return (struct layer_carousel_state){
+        .index = index,
+        .keymap_version = keymap_version,
+    };
+}
+
+PROSPECTOR_WIDGET_LISTENER_COALESCED(widget_layer_carousel, struct layer_carousel_state,
+                                     layer_carousel_update_cb, layer_carousel_get_state,
+                                     CONFIG_PROSPECTOR_LAYER_ROLLER_COALESCE_MS)
+ZMK_SUBSCRIPTION(widget_layer_carousel, zmk_layer_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+ZMK_SUBSCRIPTION(widget_layer_carousel, zmk_studio_rpc_notification);
+#endif
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+static void fade_size_event_cb(lv_event_t *e) {
+    lv_obj_t *obj = lv_event_get_target(e);
+    struct zmk_widget_layer_carousel *widget = lv_event_get_user_data(e);
+
+    fade_overlay_set_band_height(&widget->fade,
+                                 (lv_obj_get_height(obj) - carousel_row_pitch()) / 2);
+}
+#endif
+
+int zmk_widget_layer_carousel_init(struct zmk_widget_layer_carousel *widget, lv_obj_t *parent) {
+    lv_coord_t pitch = carousel_row_pitch();
+
+    widget->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(widget->obj);
+    lv_obj_clear_flag(widget->obj, LV_OBJ_FLAG_SCROLLABLE);
+
+    // The three rows move together, so only one object is animated
+    widget->strip = lv_obj_create(widget->obj);
+    lv_obj_remove_style_all(widget->strip);
+    lv_obj_clear_flag(widget->strip, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(widget->strip, lv_pct(100), pitch * LAYER_CAROUSEL_SLOTS);
+    lv_obj_center(widget->strip);
+
+    for (int i = 0; i < LAYER_CAROUSEL_SLOTS; i++) {
+        lv_obj_t *label = lv_label_create(widget->strip);
+        bool current = i == LAYER_CAROUSEL_CURRENT;
+
+        lv_obj_set_width(label, lv_pct(100));
+        lv_obj_set_pos(label, 0, pitch * i + CAROUSEL_LINE_SPACE / 2);
+        lv_label_set_long_mode(label, LV_LABEL_LONG_CLIP);
+        lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, 0);
+        lv_obj_set_style_text_font(
+            label, glyph_cache_font(current ? &FRAC_Regular_48 : &FRAC_Thin_48), 0);
+        lv_obj_set_style_text_color(label, lv_color_hex(current ? 0xffffff : 0x909090), 0);
+        widget->labels[i] = label;
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_NAME_IMAGES)
+        // Alpha-only images take their color from the recolor style
+        lv_obj_t *img = lv_img_create(widget->strip);
+
+        lv_obj_align(img, LV_ALIGN_TOP_MID, 0, pitch * i + CAROUSEL_LINE_SPACE / 2);
+        lv_obj_set_style_img_recolor(img, lv_color_hex(current ? 0xffffff : 0x909090), 0);
+        lv_obj_set_style_img_recolor_opa(img, LV_OPA_COVER, 0);
+        lv_obj_add_flag(img, LV_OBJ_FLAG_HIDDEN);
+        widget->images[i] = img;
+#endif
+    }
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_NAME_IMAGES)
+    // The carousel is sized by its caller, so anything wider than the display is cut
+    layer_images_build(lv_disp_get_hor_res(NULL));
+#endif
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+    fade_overlay_create(&widget->fade, widget->obj);
+    lv_obj_add_event_cb(widget->obj, fade_size_event_cb, LV_EVENT_SIZE_CHANGED, widget);
+#endif
+
+    for (int i = 0; i < LAYER_CAROUSEL_SLOTS; i++) {
+        widget->slot_index[i] = UINT8_MAX;
+    }
+    layer_carousel_set_index(widget, layer_names_index_of(zmk_keymap_highest_layer_active()), 0,
+                             false);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    widget_layer_carousel_init();
+    return 0;
+}
+
+void zmk_widget_layer_carousel_deinit(struct zmk_widget_layer_carousel *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+}
+
+lv_obj_t *zmk_widget_layer_carousel_obj(struct zmk_widget_layer_carousel *widget) {
+    return widget->obj;
+}
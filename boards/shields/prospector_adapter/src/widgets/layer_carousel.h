@@ -0,0 +1,39 @@
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+#include "fade_overlay.h"
+#endif
+
+enum layer_carousel_slot {
+    LAYER_CAROUSEL_PREV,
+    LAYER_CAROUSEL_CURRENT,
+    LAYER_CAROUSEL_NEXT,
+    LAYER_CAROUSEL_SLOTS,
+};
+
+/*
+ * Shows the active layer between its neighbours using three labels, whatever
+ * the number of layers in the keymap.
+ */
+struct zmk_widget_layer_carousel {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    lv_obj_t *strip;
+    lv_obj_t *labels[LAYER_CAROUSEL_SLOTS];
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_NAME_IMAGES)
+    lv_obj_t *images[LAYER_CAROUSEL_SLOTS];
+#endif
+    uint8_t slot_index[LAYER_CAROUSEL_SLOTS];
+    uint8_t index;
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+    struct fade_overlay fade;
+#endif
+};
+
+int zmk_widget_layer_carousel_init(struct zmk_widget_layer_carousel *widget, lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_layer_carousel_deinit(struct zmk_widget_layer_carousel *widget);
+lv_obj_t *zmk_widget_layer_carousel_obj(struct zmk_widget_layer_carousel *widget);
@@ -0,0 +1,69 @@
+#include "layer_images.h"
+#include "layer_names.h"
+#include "text_image.h"
+
+#include <zephyr/kernel.h>
+#include <zmk/keymap.h>
+
+#include <fonts.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define LAYER_IMAGE_WEIGHTS 2
+
+static uint8_t arena[CONFIG_PROSPECTOR_LAYER_NAME_IMAGES_ARENA] __aligned(4);
+static size_t arena_used;
+static lv_img_dsc_t images[ZMK_KEYMAP_LAYERS_LEN][LAYER_IMAGE_WEIGHTS];
+static bool built;
+
+static const lv_font_t *layer_image_font(bool current) {
+    return current ? &FRAC_Regular_48 : &FRAC_Thin_48;
+}
+
+void layer_images_build(lv_coord_t max_w) {
+    if (built) {
+        return;
+    }
+    built = true;
+
+    int64_t start = k_uptime_get();
+
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        for (int weight = 0; weight < LAYER_IMAGE_WEIGHTS; weight++) {
+            int used = text_image_render(&images[i][weight], &arena[arena_used],
+                                         sizeof(arena) - arena_used, layer_names_get(i),
+                                         layer_image_font(weight), max_w);
+            if (used < 0) {
+                LOG_WRN("No room for layer %d image, drawing it as text", i);
+                images[i][weight].data = NULL;
+                continue;
+            }
+            arena_used += used;
+
+            LOG_DBG("Layer %d %s image: %dx%d, %u bytes", i, weight ? "regular" : "thin",
+                    images[i][weight].header.w, images[i][weight].header.h,
+                    images[i][weight].data_size);
+        }
+    }
+
+    LOG_INF("Layer name images: %u of %u bytes in %lld ms", arena_used, sizeof(arena),
+            k_uptime_get() - start);
+}
+
+const lv_img_dsc_t *layer_images_get(uint8_t index, bool current) {
+    if (index >= ZMK_KEYMAP_LAYERS_LEN || images[index][current].data == NULL) {
+        return NULL;
+    }
+
+    return &images[index][current];
+}
+
+void layer_images_drop(uint32_t mask) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        if (mask & BIT(i)) {
+            images[i][0].data = NULL;
+            images[i][1].data = NULL;
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Layer names rasterized once into 4-bit alpha images, in the regular weight
+ * for the active layer and the thin weight for its neighbours. Images are
+ * drawn tinted with the image recolor style, so moving them costs a blit
+ * instead of looking up, unpacking and placing every glyph on every frame.
+ *
+ * Images live in a static arena of CONFIG_PROSPECTOR_LAYER_NAME_IMAGES_ARENA
+ * bytes; names that do not fit, or that are renamed at runtime, return NULL
+ * and should be drawn as text instead.
+ */
+
+// Renders every layer name no wider than max_w; later calls do nothing
+void layer_images_build(lv_coord_t max_w);
+const lv_img_dsc_t *layer_images_get(uint8_t index, bool current);
+// Forgets the images of the layers in mask, e.g. after they were renamed
+void layer_images_drop(uint32_t mask);
@@ -0,0 +1,183 @@
+#include "layer_names.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define KEYMAP_NODE DT_INST(0, zmk_keymap)
+
+// Longest name kept when upper-casing, and the longest joined options string
+#define LAYER_NAME_MAX_LEN    31
+#define LAYER_OPTIONS_MAX_LEN 255
+
+#define LAYER_INDEX_STRING(node) STRINGIFY(DT_NODE_CHILD_IDX(node))
+
+#define LAYER_NAME(node)                                                                           \
+    COND_CODE_1(DT_NODE_HAS_PROP(node, display_name), (DT_PROP(node, display_name)),               \
+                (COND_CODE_1(DT_NODE_HAS_PROP(node, label), (DT_PROP(node, label)),                \
+                             (LAYER_INDEX_STRING(node)))))
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+
+#define LAYER_RUNTIME_NAME_LEN CONFIG_ZMK_KEYMAP_LAYER_NAME_MAX_LEN
+
+// Unnamed layers still show their position
+static const char *const layer_index_strings[] = {
+    DT_FOREACH_CHILD_SEP(KEYMAP_NODE, LAYER_INDEX_STRING, (, ))};
+
+static const char *layer_names[ZMK_KEYMAP_LAYERS_LEN];
+static uint32_t layer_name_hashes[ZMK_KEYMAP_LAYERS_LEN];
+static bool layer_names_valid;
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS)
+static char layer_names_upper[ZMK_KEYMAP_LAYERS_LEN][LAYER_RUNTIME_NAME_LEN + 1];
+#endif
+
+// Sized for every layer at its longest name, so joining cannot overflow
+static char layer_options_buf[ZMK_KEYMAP_LAYERS_LEN * (LAYER_RUNTIME_NAME_LEN + 1)];
+
+static uint32_t layer_name_hash(const char *name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+    return hash;
+}
+
+static const char *layer_runtime_name(uint8_t index) {
+    zmk_keymap_layer_id_t id = zmk_keymap_layer_index_to_id(index);
+    const char *name = id == ZMK_KEYMAP_LAYER_ID_INVAL ? NULL : zmk_keymap_layer_name(id);
+
+    return name && *name ? name : layer_index_strings[index];
+}
+
+static void layer_options_rebuild(void) {
+    char *ptr = layer_options_buf;
+
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        size_t len = strnlen(layer_names[i], LAYER_RUNTIME_NAME_LEN);
+
+        if (i > 0) {
+            *ptr++ = '\n';
+        }
+        memcpy(ptr, layer_names[i], len);
+        ptr += len;
+    }
+    *ptr = '\0';
+}
+
+uint32_t layer_names_refresh(void) {
+    uint32_t changed = 0;
+
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        const char *name = layer_runtime_name(i);
+        uint32_t hash = layer_name_hash(name);
+
+        if (layer_names_valid && hash == layer_name_hashes[i]) {
+            continue;
+        }
+
+        layer_name_hashes[i] = hash;
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS)
+        int j;
+        for (j = 0; j < LAYER_RUNTIME_NAME_LEN && name[j]; j++) {
+            layer_names_upper[i][j] = toupper((unsigned char)name[j]);
+        }
+        layer_names_upper[i][j] = '\0';
+        name = layer_names_upper[i];
+#endif
+        layer_names[i] = name;
+        changed |= BIT(i);
+    }
+
+    if (changed) {
+        LOG_DBG("Layer names changed: 0x%08x", changed);
+        layer_options_rebuild();
+        layer_names_valid = true;
+    }
+
+    return changed;
+}
+
+const char *layer_names_options(void) {
+    if (!layer_names_valid) {
+        layer_names_refresh();
+    }
+    return layer_options_buf;
+}
+
+const char *layer_names_get(uint8_t index) {
+    if (!layer_names_valid) {
+        layer_names_refresh();
+    }
+    return index < ZMK_KEYMAP_LAYERS_LEN ? layer_names[index] : "";
+}
+
+uint8_t layer_names_index_of(zmk_keymap_layer_id_t id) {
+    for (uint8_t i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        if (zmk_keymap_layer_index_to_id(i) == id) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+#else // IS_ENABLED(CONFIG_ZMK_STUDIO)
+
+#define LAYER_NAMES_JOINED DT_FOREACH_CHILD_SEP(KEYMAP_NODE, LAYER_NAME, ("\n"))
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS)
+
+/*
+ * The preprocessor cannot transform string literals, so upper-cased copies are
+ * spelled out one character at a time into fixed size arrays, padded with NULs.
+ */
+#define LAYER_CHAR_UPPER(c) ((c) >= 'a' && (c) <= 'z' ? (c) - 'a' + 'A' : (c))
+#define LAYER_CHAR(i, s)    LAYER_CHAR_UPPER((i) < sizeof(s) ? (s)[(i) < sizeof(s) ? (i) : 0] : '\0')
+
+BUILD_ASSERT(sizeof(LAYER_NAMES_JOINED) <= LAYER_OPTIONS_MAX_LEN + 1,
+             "Layer names are too long for CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS");
+
+static const char layer_options[LAYER_OPTIONS_MAX_LEN + 1] = {
+    LISTIFY(LAYER_OPTIONS_MAX_LEN, LAYER_CHAR, (, ), LAYER_NAMES_JOINED)};
+
+#define LAYER_NAME_UPPER_DEFINE(node)                                                              \
+    BUILD_ASSERT(sizeof(LAYER_NAME(node)) <= LAYER_NAME_MAX_LEN + 1,                               \
+                 "Layer name is too long for CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS");            \
+    static const char DT_CAT(node, _prospector_name)[LAYER_NAME_MAX_LEN + 1] = {                   \
+        LISTIFY(LAYER_NAME_MAX_LEN, LAYER_CHAR, (, ), LAYER_NAME(node))};
+
+DT_FOREACH_CHILD(KEYMAP_NODE, LAYER_NAME_UPPER_DEFINE)
+
+#define LAYER_NAME_ENTRY(node) DT_CAT(node, _prospector_name)
+
+#else
+
+static const char layer_options[] = LAYER_NAMES_JOINED;
+
+#define LAYER_NAME_ENTRY(node) LAYER_NAME(node)
+
+#endif
+
+static const char *const layer_names[] = {
+    DT_FOREACH_CHILD_SEP(KEYMAP_NODE, LAYER_NAME_ENTRY, (, ))};
+
+BUILD_ASSERT(ARRAY_SIZE(layer_names) == ZMK_KEYMAP_LAYERS_LEN);
+
+// Names are fixed at build time
+uint32_t layer_names_refresh(void) { return 0; }
+
+const char *layer_names_options(void) { return layer_options; }
+
+const char *layer_names_get(uint8_t index) {
+    return index < ARRAY_SIZE(layer_names) ? layer_names[index] : "";
+}
+
+uint8_t layer_names_index_of(zmk_keymap_layer_id_t id) { return id; }
+
+#endif // IS_ENABLED(CONFIG_ZMK_STUDIO)
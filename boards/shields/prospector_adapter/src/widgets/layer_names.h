@@ -0,0 +1,29 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/keymap.h>
+
+/*
+ * Layer names generated at build time from the zmk,keymap devicetree node,
+ * already upper-cased when CONFIG_PROSPECTOR_LAYER_ROLLER_ALL_CAPS is set.
+ * The table lives in flash; unnamed layers are shown as their index.
+ *
+ * With ZMK Studio, layers can be renamed and reordered at runtime. The names
+ * are then read from the keymap and layer_names_refresh() reports which
+ * positions changed, so widgets only touch what is stale.
+ */
+
+/*
+ * All names joined by newlines, as lv_roller expects its options. The roller
+ * still copies them onto the LVGL heap, LV_ROLLER_INF_PAGES (7) times over in
+ * infinite mode; only the carousel shows the names without a copy.
+ */
+const char *layer_names_options(void);
+
+const char *layer_names_get(uint8_t index);
+
+// Position of a layer in the keymap's current layer order
+uint8_t layer_names_index_of(zmk_keymap_layer_id_t id);
+
+// Bitmask of layer positions whose name changed since the previous call
+uint32_t layer_names_refresh(void);
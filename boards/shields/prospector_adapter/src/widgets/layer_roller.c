@@ -1,22 +1,32 @@
 #include "layer_roller.h"
+#include "widget_listener.h"
+#include "layer_names.h"
+#include "render_profile.h"
+#include "glyph_cache.h"
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_MASK)
+#include "layer_roller_fade.h"
+#endif
 
-#include <ctype.h>
 #include <zmk/display.h>
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/event_manager.h>
 #include <zmk/keymap.h>
 
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+#include <zmk/studio/rpc.h>
+#endif
+
 #include <fonts.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
-static char layer_names_buffer[256] = {0}; // Buffer for concatenated layer names
-
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
 struct layer_roller_state {
     uint8_t index;
+    // Bumped by keymap edits so the names get checked for changes
+    uint8_t keymap_version;
 };
 
 static void layer_roller_set_sel(lv_obj_t *roller, struct layer_roller_state state) {
@@ -24,133 +34,93 @@ static void layer_roller_set_sel(lv_obj_t *roller, struct layer_roller_state sta
 }
 
 static void layer_roller_update_cb(struct layer_roller_state state) {
+    // lv_roller can only replace all options at once and copies them onto the LVGL heap,
+    // so only do it when a name changed
+    bool names_changed = layer_names_refresh() != 0;
+
     struct zmk_widget_layer_roller *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        if (names_changed) {
+            lv_roller_set_options(widget->obj, layer_names_options(), LV_ROLLER_MODE_INFINITE);
+        }
         layer_roller_set_sel(widget->obj, state);
     }
 }
 
 static struct layer_roller_state layer_roller_get_state(const zmk_event_t *eh) {
-    uint8_t index = zmk_keymap_highest_layer_active();
-    LOG_INF("Roller set to: %d", index);
+    static uint8_t keymap_version;
+
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+    if (eh != NULL && as_zmk_studio_rpc_notification(eh) != NULL) {
+        keymap_version++;
+    }
+#endif
+
+    uint8_t index = layer_names_index_of(zmk_keymap_highest_layer_active());
+    LOG_DBG("Roller set to: %d", index);
     return (struct layer_roller_state){
         .index = index,
+        .keymap_version = keymap_version,
     };
 }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_roller, struct layer_roller_state, layer_roller_update_cb,
-                            layer_roller_get_state)
+PROSPECTOR_WIDGET_LISTENER_COALESCED(widget_layer_roller, struct layer_roller_state,
+                                     layer_roller_update_cb, layer_roller_get_state,
+                                     CONFIG_PROSPECTOR_LAYER_ROLLER_COALESCE_MS)
 ZMK_SUBSCRIPTION(widget_layer_roller, zmk_layer_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_STUDIO)
+ZMK_SUBSCRIPTION(widget_layer_roller, zmk_studio_rpc_notification);
+#endif
 
-static void mask_event_cb(lv_event_t * e)
-{
-    lv_event_code_t code = lv_event_get_code(e);
-    lv_obj_t * obj = lv_event_get_target(e);
-
-    static int16_t mask_top_id = -1;
-    static int16_t mask_bottom_id = -1;
-
-    if(code == LV_EVENT_COVER_CHECK) {
-        lv_event_set_cover_res(e, LV_COVER_RES_MASKED);
-
-    }
-    else if(code == LV_EVENT_DRAW_MAIN_BEGIN) {
-        /* add mask */
-        const lv_font_t * font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
-        lv_coord_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
-        lv_coord_t font_h = lv_font_get_line_height(font);
-
-        lv_area_t roller_coords;
-        lv_obj_get_coords(obj, &roller_coords);
-
-        lv_area_t rect_area;
-        rect_area.x1 = roller_coords.x1;
-        rect_area.x2 = roller_coords.x2;
-        rect_area.y1 = roller_coords.y1;
-        rect_area.y2 = roller_coords.y1 + (lv_obj_get_height(obj) - font_h - line_space) / 2;
-
-        lv_draw_mask_fade_param_t * fade_mask_top = lv_mem_buf_get(sizeof(lv_draw_mask_fade_param_t));
-        lv_draw_mask_fade_init(fade_mask_top, &rect_area, LV_OPA_TRANSP, rect_area.y1, LV_OPA_COVER, rect_area.y2);
-        mask_top_id = lv_draw_mask_add(fade_mask_top, NULL);
-
-        rect_area.y1 = rect_area.y2 + font_h + line_space - 1;
-        rect_area.y2 = roller_coords.y2;
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+// Same band geometry as the mask: everything above and below the selected row
+static void fade_size_event_cb(lv_event_t *e) {
+    lv_obj_t *obj = lv_event_get_target(e);
+    struct zmk_widget_layer_roller *widget = lv_event_get_user_data(e);
 
-        lv_draw_mask_fade_param_t * fade_mask_bottom = lv_mem_buf_get(sizeof(lv_draw_mask_fade_param_t));
-        lv_draw_mask_fade_init(fade_mask_bottom, &rect_area, LV_OPA_COVER, rect_area.y1, LV_OPA_TRANSP, rect_area.y2);
-        mask_bottom_id = lv_draw_mask_add(fade_mask_bottom, NULL);
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    lv_coord_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+    lv_coord_t font_h = lv_font_get_line_height(font);
 
-    }
-    else if(code == LV_EVENT_DRAW_POST_END) {
-        lv_draw_mask_fade_param_t * fade_mask_top = lv_draw_mask_remove_id(mask_top_id);
-        lv_draw_mask_fade_param_t * fade_mask_bottom = lv_draw_mask_remove_id(mask_bottom_id);
-        lv_draw_mask_free_param(fade_mask_top);
-        lv_draw_mask_free_param(fade_mask_bottom);
-        lv_mem_buf_release(fade_mask_top);
-        lv_mem_buf_release(fade_mask_bottom);
-        mask_top_id = -1;
-        mask_bottom_id = -1;
-    }
+    fade_overlay_set_band_height(&widget->fade, (lv_obj_get_height(obj) - font_h - line_space) / 2);
 }
+#endif
 
 int zmk_widget_layer_roller_init(struct zmk_widget_layer_roller *widget, lv_obj_t *parent) {
     widget->obj = lv_roller_create(parent);
 
-    layer_names_buffer[0] = '\0';
-    char *ptr = layer_names_buffer;
-
-    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
-        const char *layer_name = zmk_keymap_layer_name(zmk_keymap_layer_index_to_id(i));
-        if (layer_name) {
-            if (i > 0) {
-                strcat(ptr, "\n");
-                ptr += strlen(ptr);
-            }
-
-            if (layer_name && *layer_name) {
-#if IS_ENABLED(CONFIG_LAYER_ROLLER_ALL_CAPS)
-                while (*layer_name) {
-                    *ptr = toupper((unsigned char)*layer_name);
-                    ptr++;
-                    layer_name++;
-                }
-                *ptr = '\0';
-#else
-                strcat(ptr, layer_name);
-                ptr += strlen(layer_name);
-#endif
-            } else {
-                // Just use the number for unnamed layers
-                char index_str[12];
-                snprintf(index_str, sizeof(index_str), "%d", i);
-                strcat(ptr, index_str);
-                ptr += strlen(index_str);
-            }
-        }
-    }
-
-    lv_roller_set_options(widget->obj, layer_names_buffer, LV_ROLLER_MODE_INFINITE);
+    lv_roller_set_options(widget->obj, layer_names_options(), LV_ROLLER_MODE_INFINITE);
 
+    // The roller is recreated whenever its page is shown; the style is set up once
     static lv_style_t style;
-    lv_style_init(&style);
-    lv_style_set_bg_color(&style, lv_color_black());
-    lv_style_set_text_color(&style, lv_color_white());
-    // lv_style_set_text_letter_space(&style, 2);
-    lv_style_set_border_width(&style, 0);
-    lv_style_set_pad_all(&style, 0);
+    static bool style_initialized = false;
+    if (!style_initialized) {
+        lv_style_init(&style);
+        lv_style_set_bg_color(&style, lv_color_black());
+        lv_style_set_text_color(&style, lv_color_white());
+        // lv_style_set_text_letter_space(&style, 2);
+        lv_style_set_border_width(&style, 0);
+        lv_style_set_pad_all(&style, 0);
+        style_initialized = true;
+    }
     // lv_obj_add_style(lv_scr_act(), &style, 0);
 
     lv_obj_add_style(widget->obj, &style, 0);
     lv_obj_set_style_bg_opa(widget->obj, LV_OPA_TRANSP, LV_PART_SELECTED);
-    lv_obj_set_style_text_font(widget->obj, &FRAC_Regular_48, LV_PART_SELECTED);
+    lv_obj_set_style_text_font(widget->obj, glyph_cache_font(&FRAC_Regular_48), LV_PART_SELECTED);
     lv_obj_set_style_text_color(widget->obj, lv_color_hex(0xffffff), LV_PART_SELECTED);
     // lv_obj_set_style_text_line_space(widget->obj, 20, LV_PART_SELECTED);
     // lv_obj_set_style_text_line_space(widget->obj, 20, LV_PART_MAIN);
-    lv_obj_set_style_text_font(widget->obj, &FRAC_Thin_48, LV_PART_MAIN);
+    lv_obj_set_style_text_font(widget->obj, glyph_cache_font(&FRAC_Thin_48), LV_PART_MAIN);
     lv_obj_set_style_text_color(widget->obj, lv_color_hex(0x909090), LV_PART_MAIN);
     // lv_obj_set_style_text_align(widget->obj, LV_TEXT_ALIGN_CENTER, 0);
 
-    lv_obj_add_event_cb(widget->obj, mask_event_cb, LV_EVENT_ALL, NULL);
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_MASK)
+    lv_obj_add_event_cb(widget->obj, layer_roller_fade_mask_cb, LV_EVENT_ALL, NULL);
+#elif IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+    fade_overlay_create(&widget->fade, widget->obj);
+    lv_obj_add_event_cb(widget->obj, fade_size_event_cb, LV_EVENT_SIZE_CHANGED, widget);
+#endif
 
     // static lv_style_t style_roller;
     // lv_style_init(&style_roller);
@@ -175,7 +145,7 @@ int zmk_widget_layer_roller_init(struct zmk_widget_layer_roller *widget, lv_obj_
     // lv_obj_add_style(widget->obj, &style_roller_sel, LV_PART_SELECTED);
     // lv_obj_set_style_radius(widget->obj, 20, LV_PART_MAIN);
 
-    lv_obj_set_style_anim_time(widget->obj, 100, 0);
+    lv_obj_set_style_anim_time(widget->obj, PROSPECTOR_ANIM_MS(100), 0);
 
     sys_slist_append(&widgets, &widget->node);
 
@@ -183,6 +153,10 @@ int zmk_widget_layer_roller_init(struct zmk_widget_layer_roller *widget, lv_obj_
     return 0;
 }
 
+void zmk_widget_layer_roller_deinit(struct zmk_widget_layer_roller *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+}
+
 lv_obj_t *zmk_widget_layer_roller_obj(struct zmk_widget_layer_roller *widget) {
     return widget->obj;
 }
\ No newline at end of file
@@ -3,10 +3,19 @@
 #include <lvgl.h>
 #include <zephyr/kernel.h>
 
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+#include "fade_overlay.h"
+#endif
+
 struct zmk_widget_layer_roller {
     sys_snode_t node;
     lv_obj_t *obj;
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+    struct fade_overlay fade;
+#endif
 };
 
 int zmk_widget_layer_roller_init(struct zmk_widget_layer_roller *widget, lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_layer_roller_deinit(struct zmk_widget_layer_roller *widget);
 lv_obj_t *zmk_widget_layer_roller_obj(struct zmk_widget_layer_roller *widget);
\ No newline at end of file
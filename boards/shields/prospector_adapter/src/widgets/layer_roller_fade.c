@@ -0,0 +1,52 @@
+#include "layer_roller_fade.h"
+
+void layer_roller_fade_mask_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t * obj = lv_event_get_target(e);
+
+    static int16_t mask_top_id = -1;
+    static int16_t mask_bottom_id = -1;
+
+    if(code == LV_EVENT_COVER_CHECK) {
+        lv_event_set_cover_res(e, LV_COVER_RES_MASKED);
+
+    }
+    else if(code == LV_EVENT_DRAW_MAIN_BEGIN) {
+        /* add mask */
+        const lv_font_t * font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+        lv_coord_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+        lv_coord_t font_h = lv_font_get_line_height(font);
+
+        lv_area_t roller_coords;
+        lv_obj_get_coords(obj, &roller_coords);
+
+        lv_area_t rect_area;
+        rect_area.x1 = roller_coords.x1;
+        rect_area.x2 = roller_coords.x2;
+        rect_area.y1 = roller_coords.y1;
+        rect_area.y2 = roller_coords.y1 + (lv_obj_get_height(obj) - font_h - line_space) / 2;
+
+        lv_draw_mask_fade_param_t * fade_mask_top = lv_mem_buf_get(sizeof(lv_draw_mask_fade_param_t));
+        lv_draw_mask_fade_init(fade_mask_top, &rect_area, LV_OPA_TRANSP, rect_area.y1, LV_OPA_COVER, rect_area.y2);
+        mask_top_id = lv_draw_mask_add(fade_mask_top, NULL);
+
+        rect_area.y1 = rect_area.y2 + font_h + line_space - 1;
+        rect_area.y2 = roller_coords.y2;
+
+        lv_draw_mask_fade_param_t * fade_mask_bottom = lv_mem_buf_get(sizeof(lv_draw_mask_fade_param_t));
+        lv_draw_mask_fade_init(fade_mask_bottom, &rect_area, LV_OPA_COVER, rect_area.y1, LV_OPA_TRANSP, rect_area.y2);
+        mask_bottom_id = lv_draw_mask_add(fade_mask_bottom, NULL);
+
+    }
+    else if(code == LV_EVENT_DRAW_POST_END) {
+        lv_draw_mask_fade_param_t * fade_mask_top = lv_draw_mask_remove_id(mask_top_id);
+        lv_draw_mask_fade_param_t * fade_mask_bottom = lv_draw_mask_remove_id(mask_bottom_id);
+        lv_draw_mask_free_param(fade_mask_top);
+        lv_draw_mask_free_param(fade_mask_bottom);
+        lv_mem_buf_release(fade_mask_top);
+        lv_mem_buf_release(fade_mask_bottom);
+        mask_top_id = -1;
+        mask_bottom_id = -1;
+    }
+}
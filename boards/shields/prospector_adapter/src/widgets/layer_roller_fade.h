@@ -0,0 +1,9 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Fades the roller rows above and below the selected one towards transparent
+ * with draw masks applied on every frame. Add it for LV_EVENT_ALL.
+ */
+void layer_roller_fade_mask_cb(lv_event_t *e);
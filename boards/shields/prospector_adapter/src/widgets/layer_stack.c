@@ -0,0 +1,115 @@
+#include "layer_stack.h"
+#include "widget_listener.h"
+
+#include <zmk/display.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/event_manager.h>
+#include <zmk/keymap.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define LAYER_STACK_SEGMENT_W   16
+#define LAYER_STACK_SEGMENT_H   4
+#define LAYER_STACK_SEGMENT_GAP 3
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// Shared by every segment; active layers are shown by toggling LV_STATE_CHECKED
+static lv_style_t style_segment;
+static lv_style_t style_segment_active;
+
+struct layer_stack_state {
+    zmk_keymap_layers_state_t layers;
+};
+
+static void layer_stack_set_layers(struct zmk_widget_layer_stack *widget,
+                                   zmk_keymap_layers_state_t layers) {
+    zmk_keymap_layers_state_t changed = layers ^ widget->shown;
+
+    widget->shown = layers;
+
+    while (changed) {
+        int i = __builtin_ctz(changed);
+        changed &= changed - 1;
+
+        if (i >= ZMK_KEYMAP_LAYERS_LEN) {
+            break;
+        }
+
+        if (layers & BIT(i)) {
+            lv_obj_add_state(widget->segments[i], LV_STATE_CHECKED);
+        } else {
+            lv_obj_clear_state(widget->segments[i], LV_STATE_CHECKED);
+        }
+    }
+}
+
+static void layer_stack_update_cb(struct layer_stack_state state) {
+    struct zmk_widget_layer_stack *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        layer_stack_set_layers(widget, state.layers);
+    }
+}
+
+static struct layer_stack_state layer_stack_get_state(const zmk_event_t *eh) {
+    return (struct layer_stack_state){
+        .layers = zmk_keymap_layer_state(),
+    };
+}
+
+PROSPECTOR_WIDGET_LISTENER(widget_layer_stack, struct layer_stack_state, layer_stack_update_cb,
+                           layer_stack_get_state)
+ZMK_SUBSCRIPTION(widget_layer_stack, zmk_layer_state_changed);
+
+static void layer_stack_init_styles(void) {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    lv_style_init(&style_segment);
+    lv_style_set_bg_color(&style_segment, lv_color_hex(0x202020));
+    lv_style_set_bg_opa(&style_segment, LV_OPA_COVER);
+    lv_style_set_radius(&style_segment, 1);
+    lv_style_set_border_width(&style_segment, 0);
+
+    lv_style_init(&style_segment_active);
+    lv_style_set_bg_color(&style_segment_active, lv_color_hex(0xffffff));
+}
+
+int zmk_widget_layer_stack_init(struct zmk_widget_layer_stack *widget, lv_obj_t *parent) {
+    layer_stack_init_styles();
+
+    widget->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(widget->obj);
+    lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_clear_flag(widget->obj, LV_OBJ_FLAG_SCROLLABLE);
+    // Base layer at the bottom, like the layers stack up in the keymap
+    lv_obj_set_flex_flow(widget->obj, LV_FLEX_FLOW_COLUMN_REVERSE);
+    lv_obj_set_style_pad_row(widget->obj, LAYER_STACK_SEGMENT_GAP, LV_PART_MAIN);
+
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        lv_obj_t *segment = lv_obj_create(widget->obj);
+        lv_obj_remove_style_all(segment);
+        lv_obj_set_size(segment, LAYER_STACK_SEGMENT_W, LAYER_STACK_SEGMENT_H);
+        lv_obj_add_style(segment, &style_segment, LV_PART_MAIN);
+        lv_obj_add_style(segment, &style_segment_active, LV_PART_MAIN | LV_STATE_CHECKED);
+        widget->segments[i] = segment;
+    }
+    widget->shown = 0;
+
+    sys_slist_append(&widgets, &widget->node);
+
+    widget_layer_stack_init();
+    return 0;
+}
+
+void zmk_widget_layer_stack_deinit(struct zmk_widget_layer_stack *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+}
+
+lv_obj_t *zmk_widget_layer_stack_obj(struct zmk_widget_layer_stack *widget) {
+    return widget->obj;
+}
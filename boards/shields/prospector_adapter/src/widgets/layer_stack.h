@@ -0,0 +1,17 @@
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+#include <zmk/keymap.h>
+
+struct zmk_widget_layer_stack {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    lv_obj_t *segments[ZMK_KEYMAP_LAYERS_LEN];
+    zmk_keymap_layers_state_t shown;
+};
+
+int zmk_widget_layer_stack_init(struct zmk_widget_layer_stack *widget, lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_layer_stack_deinit(struct zmk_widget_layer_stack *widget);
+lv_obj_t *zmk_widget_layer_stack_obj(struct zmk_widget_layer_stack *widget);
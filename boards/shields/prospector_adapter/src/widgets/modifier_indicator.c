@@ -0,0 +1,148 @@
+#include "modifier_indicator.h"
+#include "widget_listener.h"
+
+#include <dt-bindings/zmk/hid_usage.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+#include <zmk/display.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/event_manager.h>
+#include <zmk/hid.h>
+
+#include <fonts.h>
+#include <sf_symbols.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// Shared by every glyph; held modifiers are shown by toggling LV_STATE_CHECKED
+static lv_style_t style_glyph;
+static lv_style_t style_glyph_active;
+
+// Same bit order as the HID modifier byte, left and right sides folded together
+static const char *const modifier_symbols[MODIFIER_INDICATOR_GLYPHS] = {
+    [MODIFIER_INDICATOR_CONTROL] = SF_SYMBOL_CONTROL,
+    [MODIFIER_INDICATOR_OPTION] = SF_SYMBOL_OPTION,
+    [MODIFIER_INDICATOR_SHIFT] = SF_SYMBOL_SHIFT,
+    [MODIFIER_INDICATOR_COMMAND] = SF_SYMBOL_COMMAND,
+};
+
+static const uint8_t modifier_glyph_bits[MODIFIER_INDICATOR_GLYPHS] = {
+    [MODIFIER_INDICATOR_CONTROL] = BIT(0),
+    [MODIFIER_INDICATOR_SHIFT] = BIT(1),
+    [MODIFIER_INDICATOR_OPTION] = BIT(2),
+    [MODIFIER_INDICATOR_COMMAND] = BIT(3),
+};
+
+struct modifier_indicator_state {
+    zmk_mod_flags_t mods;
+};
+
+static void modifier_indicator_set_mods(struct zmk_widget_modifier_indicator *widget,
+                                        zmk_mod_flags_t mods) {
+    uint8_t sides = (mods | (mods >> 4)) & 0x0f;
+    uint8_t changed = sides ^ widget->shown;
+
+    widget->shown = sides;
+
+    for (int i = 0; i < MODIFIER_INDICATOR_GLYPHS; i++) {
+        if (!(changed & modifier_glyph_bits[i])) {
+            continue;
+        }
+
+        if (sides & modifier_glyph_bits[i]) {
+            lv_obj_add_state(widget->glyphs[i], LV_STATE_CHECKED);
+        } else {
+            lv_obj_clear_state(widget->glyphs[i], LV_STATE_CHECKED);
+        }
+    }
+}
+
+static void modifier_indicator_update_cb(struct modifier_indicator_state state) {
+    struct zmk_widget_modifier_indicator *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        modifier_indicator_set_mods(widget, state.mods);
+    }
+}
+
+static struct modifier_indicator_state modifier_indicator_get_state(const zmk_event_t *eh) {
+    zmk_mod_flags_t mods = zmk_hid_get_explicit_mods();
+
+    /*
+     * Listener order against the HID listener isn't guaranteed, so apply this
+     * event's own effect on top of whatever the report already contains.
+     */
+    const struct zmk_keycode_state_changed *ev =
+        eh != NULL ? as_zmk_keycode_state_changed(eh) : NULL;
+    if (ev != NULL && ev->usage_page == HID_USAGE_KEY) {
+        zmk_mod_flags_t ev_mods = ev->explicit_modifiers;
+        if (ev->keycode >= HID_USAGE_KEY_KEYBOARD_LEFTCONTROL &&
+            ev->keycode <= HID_USAGE_KEY_KEYBOARD_RIGHT_GUI) {
+            ev_mods |= BIT(ev->keycode - HID_USAGE_KEY_KEYBOARD_LEFTCONTROL);
+        }
+
+        if (ev->state) {
+            mods |= ev_mods;
+        } else {
+            mods &= ~ev_mods;
+        }
+    }
+
+    return (struct modifier_indicator_state){
+        .mods = mods,
+    };
+}
+
+PROSPECTOR_WIDGET_LISTENER(widget_modifier_indicator, struct modifier_indicator_state,
+                           modifier_indicator_update_cb, modifier_indicator_get_state)
+ZMK_SUBSCRIPTION(widget_modifier_indicator, zmk_keycode_state_changed);
+
+static void modifier_indicator_init_styles(void) {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    lv_style_init(&style_glyph);
+    lv_style_set_text_font(&style_glyph, &SF_Compact_Text_Bold_32);
+    lv_style_set_text_color(&style_glyph, lv_color_hex(0x202020));
+
+    lv_style_init(&style_glyph_active);
+    lv_style_set_text_color(&style_glyph_active, lv_color_hex(0xffffff));
+}
+
+int zmk_widget_modifier_indicator_init(struct zmk_widget_modifier_indicator *widget,
+                                       lv_obj_t *parent) {
+    modifier_indicator_init_styles();
+
+    widget->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(widget->obj);
+    lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    lv_obj_clear_flag(widget->obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_flex_flow(widget->obj, LV_FLEX_FLOW_ROW);
+    lv_obj_set_style_pad_column(widget->obj, 6, LV_PART_MAIN);
+
+    for (int i = 0; i < MODIFIER_INDICATOR_GLYPHS; i++) {
+        lv_obj_t *glyph = lv_label_create(widget->obj);
+        lv_label_set_text_static(glyph, modifier_symbols[i]);
+        lv_obj_add_style(glyph, &style_glyph, LV_PART_MAIN);
+        lv_obj_add_style(glyph, &style_glyph_active, LV_PART_MAIN | LV_STATE_CHECKED);
+        widget->glyphs[i] = glyph;
+    }
+    widget->shown = 0;
+
+    sys_slist_append(&widgets, &widget->node);
+
+    widget_modifier_indicator_init();
+    return 0;
+}
+
+void zmk_widget_modifier_indicator_deinit(struct zmk_widget_modifier_indicator *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+}
+
+lv_obj_t *zmk_widget_modifier_indicator_obj(struct zmk_widget_modifier_indicator *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+enum modifier_indicator_glyph {
+    MODIFIER_INDICATOR_CONTROL,
+    MODIFIER_INDICATOR_OPTION,
+    MODIFIER_INDICATOR_SHIFT,
+    MODIFIER_INDICATOR_COMMAND,
+    MODIFIER_INDICATOR_GLYPHS,
+};
+
+struct zmk_widget_modifier_indicator {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    lv_obj_t *glyphs[MODIFIER_INDICATOR_GLYPHS];
+    uint8_t shown;
+};
+
+int zmk_widget_modifier_indicator_init(struct zmk_widget_modifier_indicator *widget,
+                                       lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_modifier_indicator_deinit(struct zmk_widget_modifier_indicator *widget);
+lv_obj_t *zmk_widget_modifier_indicator_obj(struct zmk_widget_modifier_indicator *widget);
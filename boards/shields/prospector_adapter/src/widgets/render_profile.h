@@ -0,0 +1,35 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Build-time switches for the expensive parts of the widgets, picked by
+ * CONFIG_PROSPECTOR_RENDER_PROFILE. The layer widget fade follows the profile
+ * through the defaults of CONFIG_PROSPECTOR_LAYER_ROLLER_FADE.
+ */
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_RENDER_PROFILE_FAST)
+
+#define PROSPECTOR_RENDER_PROFILE_NAME "fast"
+#define PROSPECTOR_ANIM_MS(ms)         0
+#define PROSPECTOR_BAR_GRADIENT        0
+#define PROSPECTOR_BAR_DITHER          LV_DITHER_NONE
+#define PROSPECTOR_FADES               0
+
+#elif IS_ENABLED(CONFIG_PROSPECTOR_RENDER_PROFILE_BALANCED)
+
+#define PROSPECTOR_RENDER_PROFILE_NAME "balanced"
+#define PROSPECTOR_ANIM_MS(ms)         ((ms) / 2)
+#define PROSPECTOR_BAR_GRADIENT        1
+#define PROSPECTOR_BAR_DITHER          LV_DITHER_ORDERED
+#define PROSPECTOR_FADES               1
+
+#else
+
+#define PROSPECTOR_RENDER_PROFILE_NAME "quality"
+#define PROSPECTOR_ANIM_MS(ms)         (ms)
+#define PROSPECTOR_BAR_GRADIENT        1
+#define PROSPECTOR_BAR_DITHER          LV_DITHER_ERR_DIFF
+#define PROSPECTOR_FADES               1
+
+#endif
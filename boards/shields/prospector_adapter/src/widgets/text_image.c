@@ -0,0 +1,77 @@
+#include "text_image.h"
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+// Glyph boxes are packed back to back, most significant bits first
+static uint8_t glyph_alpha(const uint8_t *bitmap, uint8_t bpp, uint32_t i) {
+    uint8_t max = BIT(bpp) - 1;
+    uint32_t bit = i * bpp;
+
+    return ((bitmap[bit >> 3] >> (8 - bpp - (bit & 7))) & max) * 255 / max;
+}
+
+// Keeps the stronger of two overlapping pixels
+static void text_image_draw_letter(lv_img_dsc_t *img, const lv_font_t *font, lv_coord_t pen_x,
+                                   const lv_font_glyph_dsc_t *g, uint32_t letter) {
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(g->resolved_font, letter);
+    if (bitmap == NULL || (g->bpp != 1 && g->bpp != 2 && g->bpp != 4)) {
+        return;
+    }
+
+    lv_coord_t top = font->line_height - font->base_line - g->box_h - g->ofs_y;
+
+    for (lv_coord_t y = 0; y < g->box_h; y++) {
+        for (lv_coord_t x = 0; x < g->box_w; x++) {
+            lv_coord_t px = pen_x + g->ofs_x + x;
+            lv_coord_t py = top + y;
+            if (px < 0 || px >= img->header.w || py < 0 || py >= img->header.h) {
+                continue;
+            }
+
+            uint8_t alpha = glyph_alpha(bitmap, g->bpp, y * g->box_w + x);
+            if (alpha > lv_img_buf_get_px_alpha(img, px, py)) {
+                lv_img_buf_set_px_alpha(img, px, py, alpha);
+            }
+        }
+    }
+}
+
+int text_image_render(lv_img_dsc_t *img, uint8_t *buf, size_t buf_size, const char *text,
+                      const lv_font_t *font, lv_coord_t max_w) {
+    lv_coord_t w = MIN(lv_txt_get_width(text, strlen(text), font, 0, LV_TEXT_FLAG_NONE), max_w);
+    lv_coord_t h = lv_font_get_line_height(font);
+    size_t size = lv_img_buf_get_img_size(MAX(w, 1), h, LV_IMG_CF_ALPHA_4BIT);
+
+    if (size > buf_size) {
+        return -ENOMEM;
+    }
+
+    *img = (lv_img_dsc_t){
+        .header.cf = LV_IMG_CF_ALPHA_4BIT,
+        .header.w = MAX(w, 1),
+        .header.h = h,
+        .data_size = size,
+        .data = buf,
+    };
+    memset(buf, 0, size);
+
+    uint32_t i = 0;
+    lv_coord_t pen_x = 0;
+    while (text[i] != '\0') {
+        uint32_t letter;
+        uint32_t letter_next;
+        lv_font_glyph_dsc_t g;
+
+        _lv_txt_encoded_letter_next_2(text, &letter, &letter_next, &i);
+        if (!lv_font_get_glyph_dsc(font, &g, letter, letter_next)) {
+            continue;
+        }
+
+        text_image_draw_letter(img, font, pen_x, &g, letter);
+        pen_x += g.adv_w;
+    }
+
+    return size;
+}
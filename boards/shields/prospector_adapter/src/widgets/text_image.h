@@ -0,0 +1,12 @@
+#pragma once
+
+#include <lvgl.h>
+
+/*
+ * Rasterizes text in a 1, 2 or 4bpp font into a 4-bit alpha image one line
+ * high and at most max_w wide, placing glyphs the way lv_draw_letter does.
+ * The pixels go to buf. Returns the bytes of buf used, or -ENOMEM if the
+ * image needs more than buf_size.
+ */
+int text_image_render(lv_img_dsc_t *img, uint8_t *buf, size_t buf_size, const char *text,
+                      const lv_font_t *font, lv_coord_t max_w);
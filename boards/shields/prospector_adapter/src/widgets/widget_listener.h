@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+
+/*
+ * Drop-in replacement for ZMK_DISPLAY_WIDGET_LISTENER that remembers the last
+ * state handed to cb and drops updates that would render the same thing again,
+ * both before submitting display work and when the work runs. States are
+ * compared with memcmp, so state types must not contain padding.
+ *
+ * Events only overwrite the pending state. The first one in a quiet period
+ * schedules the display work period_ms out, and everything that arrives before
+ * it runs is folded in, so a burst renders once with its final state.
+ *
+ * state_func may be called with a NULL event when the listener is (re)initialized.
+ */
+#define PROSPECTOR_WIDGET_LISTENER(listener, state_type, cb, state_func)                          \
+    PROSPECTOR_WIDGET_LISTENER_COALESCED(listener, state_type, cb, state_func,                     \
+                                         CONFIG_PROSPECTOR_WIDGET_COALESCE_MS)
+
+#define PROSPECTOR_WIDGET_LISTENER_COALESCED(listener, state_type, cb, state_func, period_ms)     \
+    K_MUTEX_DEFINE(listener##_mutex);                                                              \
+    static state_type __##listener##_state;                                                        \
+    static state_type __##listener##_rendered;                                                     \
+    static bool __##listener##_rendered_valid;                                                     \
+    static uint32_t listener##_events;                                                             \
+    static uint32_t listener##_events_dropped;                                                     \
+    static uint32_t listener##_refreshes;                                                          \
+    static uint32_t listener##_refreshes_skipped;                                                  \
+    static bool __##listener##_changed(void) {                                                     \
+        return !__##listener##_rendered_valid ||                                                   \
+               memcmp(&__##listener##_state, &__##listener##_rendered, sizeof(state_type)) != 0;   \
+    }                                                                                              \
+    static void __##listener##_log_suppressed(void) {                                              \
+        LOG_DBG(#listener ": dropped %u of %u events, skipped %u of %u refreshes",                 \
+                listener##_events_dropped, listener##_events, listener##_refreshes_skipped,        \
+                listener##_refreshes);                                                             \
+    }                                                                                              \
+    /* cb renders from a copy, so producers only wait for the copy, never for LVGL */              \
+    static void listener##_refresh(struct k_work *work) {                                          \
+        k_mutex_lock(&listener##_mutex, K_FOREVER);                                                \
+        state_type state = __##listener##_state;                                                   \
+        bool changed = __##listener##_changed();                                                   \
+        listener##_refreshes++;                                                                    \
+        if (changed) {                                                                             \
+            __##listener##_rendered = state;                                                       \
+            __##listener##_rendered_valid = true;                                                  \
+        } else {                                                                                   \
+            listener##_refreshes_skipped++;                                                        \
+            __##listener##_log_suppressed();                                                       \
+        }                                                                                          \
+        k_mutex_unlock(&listener##_mutex);                                                         \
+        if (changed) {                                                                             \
+            cb(state);                                                                             \
+        }                                                                                          \
+    }                                                                                              \
+    K_WORK_DELAYABLE_DEFINE(listener##_work, listener##_refresh);                                  \
+    static void listener##_init() {                                                                \
+        k_mutex_lock(&listener##_mutex, K_FOREVER);                                                \
+        __##listener##_state = state_func(NULL);                                                   \
+        __##listener##_rendered_valid = false;                                                     \
+        k_mutex_unlock(&listener##_mutex);                                                         \
+        k_work_reschedule_for_queue(zmk_display_work_q(), &listener##_work, K_NO_WAIT);            \
+    }                                                                                              \
+    static int listener##_cb(const zmk_event_t *eh) {                                              \
+        if (zmk_display_is_initialized()) {                                                        \
+            k_mutex_lock(&listener##_mutex, K_FOREVER);                                            \
+            listener##_events++;                                                                   \
+            __##listener##_state = state_func(eh);                                                 \
+            bool changed = __##listener##_changed();                                               \
+            if (!changed) {                                                                        \
+                listener##_events_dropped++;                                                       \
+                __##listener##_log_suppressed();                                                   \
+            }                                                                                      \
+            k_mutex_unlock(&listener##_mutex);                                                     \
+            if (changed) {                                                                         \
+                k_work_schedule_for_queue(zmk_display_work_q(), &listener##_work,                  \
+                                          K_MSEC(period_ms));                                      \
+            }                                                                                      \
+        }                                                                                          \
+        return ZMK_EV_EVENT_BUBBLE;                                                                \
+    }                                                                                              \
+    ZMK_LISTENER(listener, listener##_cb);
@@ -0,0 +1,90 @@
+#include "wpm.h"
+#include "wpm_window.h"
+
+#include <stdio.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/event_manager.h>
+
+#include <fonts.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define WPM_REFRESH_MS 1000
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+static struct wpm_window window;
+static struct k_spinlock window_lock;
+static lv_timer_t *refresh_timer;
+
+static uint32_t wpm_now_s(void) { return (uint32_t)(k_uptime_get() / MSEC_PER_SEC); }
+
+// Presses only touch the counters; rendering happens on the refresh timer
+static int wpm_position_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev != NULL && ev->state) {
+        K_SPINLOCK(&window_lock) { wpm_window_add(&window, wpm_now_s()); }
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_wpm, wpm_position_listener);
+ZMK_SUBSCRIPTION(widget_wpm, zmk_position_state_changed);
+
+static void wpm_set_value(struct zmk_widget_wpm *widget, uint32_t wpm) {
+    if (widget->shown == (int32_t)wpm) {
+        return;
+    }
+    widget->shown = wpm;
+
+    snprintf(widget->text, sizeof(widget->text), "%u WPM", wpm);
+    lv_label_set_text_static(widget->obj, widget->text);
+}
+
+static void wpm_refresh_timer_cb(lv_timer_t *timer) {
+    uint32_t wpm;
+
+    K_SPINLOCK(&window_lock) { wpm = wpm_window_wpm(&window, wpm_now_s()); }
+
+    struct zmk_widget_wpm *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        wpm_set_value(widget, wpm);
+    }
+}
+
+int zmk_widget_wpm_init(struct zmk_widget_wpm *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+    lv_obj_set_style_text_font(widget->obj, &FoundryGridnikMedium_20, LV_PART_MAIN);
+    lv_obj_set_style_text_color(widget->obj, lv_color_hex(0x909090), LV_PART_MAIN);
+
+    widget->shown = -1;
+    wpm_set_value(widget, 0);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    if (refresh_timer == NULL) {
+        refresh_timer = lv_timer_create(wpm_refresh_timer_cb, WPM_REFRESH_MS, NULL);
+    }
+
+    return 0;
+}
+
+static int wpm_init(void) {
+    wpm_window_init(&window, CONFIG_PROSPECTOR_WPM_WINDOW_S, wpm_now_s());
+    return 0;
+}
+
+SYS_INIT(wpm_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+void zmk_widget_wpm_deinit(struct zmk_widget_wpm *widget) {
+    sys_slist_find_and_remove(&widgets, &widget->node);
+
+    if (sys_slist_is_empty(&widgets) && refresh_timer != NULL) {
+        lv_timer_del(refresh_timer);
+        refresh_timer = NULL;
+    }
+}
+
+lv_obj_t *zmk_widget_wpm_obj(struct zmk_widget_wpm *widget) { return widget->obj; }
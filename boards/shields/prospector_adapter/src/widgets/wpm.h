@@ -0,0 +1,16 @@
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_wpm {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    char text[12];
+    int32_t shown;
+};
+
+int zmk_widget_wpm_init(struct zmk_widget_wpm *widget, lv_obj_t *parent);
+// Stops updates to the widget; its objects are freed along with their parent
+void zmk_widget_wpm_deinit(struct zmk_widget_wpm *widget);
+lv_obj_t *zmk_widget_wpm_obj(struct zmk_widget_wpm *widget);
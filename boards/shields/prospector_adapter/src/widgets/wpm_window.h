@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Keystroke counter over a sliding window of one-second buckets. Adding a
+ * press and reading the rate are O(1) amortized: the rolling sum is kept up to
+ * date, and advancing time only clears the buckets that fell out of the window.
+ *
+ * Plain C with no Zephyr dependencies, so the math can be exercised on a host.
+ */
+
+#define WPM_WINDOW_MAX_S 60
+
+// The usual convention: a word is five keystrokes
+#define WPM_KEYSTROKES_PER_WORD 5
+
+struct wpm_window {
+    uint16_t buckets[WPM_WINDOW_MAX_S];
+    uint32_t sum;
+    uint32_t head_s;
+    uint8_t len_s;
+};
+
+static inline void wpm_window_init(struct wpm_window *w, uint8_t len_s, uint32_t now_s) {
+    memset(w, 0, sizeof(*w));
+    w->len_s = len_s < 1 ? 1 : (len_s > WPM_WINDOW_MAX_S ? WPM_WINDOW_MAX_S : len_s);
+    w->head_s = now_s;
+}
+
+static inline void wpm_window_advance(struct wpm_window *w, uint32_t now_s) {
+    // Signed, so the window keeps sliding when the seconds counter wraps around
+    int32_t elapsed = (int32_t)(now_s - w->head_s);
+
+    if (elapsed <= 0) {
+        return;
+    }
+
+    if ((uint32_t)elapsed >= w->len_s) {
+        memset(w->buckets, 0, sizeof(w->buckets));
+        w->sum = 0;
+        w->head_s = now_s;
+        return;
+    }
+
+    while (w->head_s != now_s) {
+        w->head_s++;
+        uint16_t *bucket = &w->buckets[w->head_s % w->len_s];
+        w->sum -= *bucket;
+        *bucket = 0;
+    }
+}
+
+static inline void wpm_window_add(struct wpm_window *w, uint32_t now_s) {
+    wpm_window_advance(w, now_s);
+
+    uint16_t *bucket = &w->buckets[w->head_s % w->len_s];
+    if (*bucket < UINT16_MAX) {
+        (*bucket)++;
+        w->sum++;
+    }
+}
+
+static inline uint32_t wpm_window_wpm(struct wpm_window *w, uint32_t now_s) {
+    wpm_window_advance(w, now_s);
+
+    return w->sum * 60 / (w->len_s * WPM_KEYSTROKES_PER_WORD);
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#define PSPTR_BRI_UP 0
+#define PSPTR_BRI_DN 1
+#define PSPTR_BRI_AUTO 2
+#define PSPTR_BRI_TOG 3
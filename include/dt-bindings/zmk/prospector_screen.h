@@ -0,0 +1,5 @@
+#pragma once
+
+#define PSPTR_SCR_HEATMAP 0
+#define PSPTR_SCR_NEXT 1
+#define PSPTR_SCR_PREV 2
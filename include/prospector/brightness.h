@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Turn the backlight and the panel fully off (blank = true) or bring them back
+ * to the current brightness level. Safe to call repeatedly with the same value.
+ */
+void prospector_brightness_blank(bool blank);
+bool prospector_brightness_is_blanked(void);
+
+/*
+ * User adjustments on top of the ambient or fixed level. The offset is
+ * persisted through settings; auto drops it back to zero.
+ */
+void prospector_brightness_adjust(int8_t delta);
+void prospector_brightness_auto(void);
+void prospector_brightness_toggle(void);
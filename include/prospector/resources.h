@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/devicetree.h>
+
+/*
+ * Glyph bitmaps built into a resource pack live in the QSPI flash partition
+ * labelled prospector_resources_partition and are read in place through the
+ * nRF52840 XIP window, so fonts point straight at them with no copy.
+ */
+#define PROSPECTOR_RESOURCE_PARTITION DT_NODELABEL(prospector_resources_partition)
+
+// The XIP window is the second register block of the QSPI peripheral
+#define PROSPECTOR_RESOURCE_XIP_BASE                                                               \
+    (DT_REG_ADDR_BY_IDX(DT_NODELABEL(qspi), 1) + DT_REG_ADDR(PROSPECTOR_RESOURCE_PARTITION))
+
+#define PROSPECTOR_RESOURCE_HEADER_SIZE 16
+
+// Address of data at offset in the pack, past its header
+#define PROSPECTOR_RESOURCE(offset)                                                                \
+    ((const uint8_t *)(PROSPECTOR_RESOURCE_XIP_BASE + PROSPECTOR_RESOURCE_HEADER_SIZE + (offset)))
+
+/*
+ * True once XIP is on and the pack in flash matches the one the firmware was
+ * built with. Fonts from the pack must not be drawn before that.
+ */
+bool prospector_resources_ready(void);
@@ -0,0 +1,12 @@
+#pragma once
+
+/*
+ * Page switching on the status screen. Can be called from any thread; the
+ * switch happens on the display work queue, and requests that arrive before
+ * it runs are combined.
+ */
+void prospector_screen_next(void);
+void prospector_screen_prev(void);
+
+// Switch to the key press heatmap, or back to the page shown before it
+void prospector_screen_heatmap_toggle(void);
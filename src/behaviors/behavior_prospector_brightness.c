@@ -0,0 +1,94 @@
+#define DT_DRV_COMPAT zmk_behavior_prospector_brightness
+
+#include <zephyr/device.h>
+#include <drivers/behavior.h>
+#include <zephyr/logging/log.h>
+#include <zmk/behavior.h>
+
+#include <dt-bindings/zmk/prospector_brightness.h>
+#include <prospector/brightness.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
+
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static const struct behavior_parameter_value_metadata param_values[] = {
+    {
+        .display_name = "Brightness Up",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_VALUE,
+        .value = PSPTR_BRI_UP,
+    },
+    {
+        .display_name = "Brightness Down",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_VALUE,
+        .value = PSPTR_BRI_DN,
+    },
+    {
+        .display_name = "Auto Brightness",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_VALUE,
+        .value = PSPTR_BRI_AUTO,
+    },
+    {
+        .display_name = "Toggle Display",
+        .type = BEHAVIOR_PARAMETER_VALUE_TYPE_VALUE,
+        .value = PSPTR_BRI_TOG,
+    },
+};
+
+static const struct behavior_parameter_metadata_set param_metadata_set[] = {{
+    .param1_values = param_values,
+    .param1_values_len = ARRAY_SIZE(param_values),
+}};
+
+static const struct behavior_parameter_metadata metadata = {
+    .sets_len = ARRAY_SIZE(param_metadata_set),
+    .sets = param_metadata_set,
+};
+
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+
+static int on_prospector_brightness_binding_pressed(struct zmk_behavior_binding *binding,
+                                                    struct zmk_behavior_binding_event event) {
+    switch (binding->param1) {
+    case PSPTR_BRI_UP:
+        prospector_brightness_adjust(CONFIG_PROSPECTOR_BRIGHTNESS_STEP);
+        break;
+    case PSPTR_BRI_DN:
+        prospector_brightness_adjust(-CONFIG_PROSPECTOR_BRIGHTNESS_STEP);
+        break;
+    case PSPTR_BRI_AUTO:
+        prospector_brightness_auto();
+        break;
+    case PSPTR_BRI_TOG:
+        prospector_brightness_toggle();
+        break;
+    default:
+        LOG_ERR("Unknown brightness command: %d", binding->param1);
+        return -ENOTSUP;
+    }
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int on_prospector_brightness_binding_released(struct zmk_behavior_binding *binding,
+                                                     struct zmk_behavior_binding_event event) {
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static const struct behavior_driver_api behavior_prospector_brightness_driver_api = {
+    .binding_pressed = on_prospector_brightness_binding_pressed,
+    .binding_released = on_prospector_brightness_binding_released,
+#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+    .parameter_metadata = &metadata,
+#endif // IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
+};
+
+static int behavior_prospector_brightness_init(const struct device *dev) { return 0; }
+
+BEHAVIOR_DT_INST_DEFINE(0, behavior_prospector_brightness_init, NULL, NULL, NULL, POST_KERNEL,
+                        CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+                        &behavior_prospector_brightness_driver_api);
+
+#endif
@@ -0,0 +1,60 @@
+#define DT_DRV_COMPAT zmk_fake_light_sensor
+
+#include "fake_light_sensor.h"
+
+struct fake_light_sensor_data {
+    struct sensor_value value;
+    int fetch_ret;
+    uint32_t fetches;
+};
+
+static int fake_light_sensor_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    struct fake_light_sensor_data *data = dev->data;
+
+    data->fetches++;
+    return data->fetch_ret;
+}
+
+static int fake_light_sensor_channel_get(const struct device *dev, enum sensor_channel chan,
+                                         struct sensor_value *val) {
+    struct fake_light_sensor_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_LIGHT) {
+        return -ENOTSUP;
+    }
+
+    *val = data->value;
+    return 0;
+}
+
+static const struct sensor_driver_api fake_light_sensor_api = {
+    .sample_fetch = fake_light_sensor_sample_fetch,
+    .channel_get = fake_light_sensor_channel_get,
+};
+
+void fake_light_sensor_set(const struct device *dev, int32_t val1, int32_t val2) {
+    struct fake_light_sensor_data *data = dev->data;
+
+    data->value.val1 = val1;
+    data->value.val2 = val2;
+}
+
+void fake_light_sensor_set_error(const struct device *dev, int ret) {
+    struct fake_light_sensor_data *data = dev->data;
+
+    data->fetch_ret = ret;
+}
+
+uint32_t fake_light_sensor_fetches(const struct device *dev) {
+    struct fake_light_sensor_data *data = dev->data;
+
+    return data->fetches;
+}
+
+#define FAKE_LIGHT_SENSOR_DEFINE(inst)                                                             \
+    static struct fake_light_sensor_data fake_light_sensor_data_##inst;                            \
+    SENSOR_DEVICE_DT_INST_DEFINE(inst, NULL, NULL, &fake_light_sensor_data_##inst, NULL,           \
+                                 POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,                         \
+                                 &fake_light_sensor_api);
+
+DT_INST_FOREACH_STATUS_OKAY(FAKE_LIGHT_SENSOR_DEFINE)
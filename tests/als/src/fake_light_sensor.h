@@ -0,0 +1,10 @@
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+// The next readings of SENSOR_CHAN_LIGHT
+void fake_light_sensor_set(const struct device *dev, int32_t val1, int32_t val2);
+// Makes every fetch fail with ret, or succeed again with 0
+void fake_light_sensor_set_error(const struct device *dev, int ret);
+uint32_t fake_light_sensor_fetches(const struct device *dev);
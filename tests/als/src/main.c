@@ -0,0 +1,80 @@
+#include <string.h>
+#include <zephyr/ztest.h>
+
+#include "als.h"
+#include "fake_light_sensor.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(als, 4);
+
+// From boards/native_sim.overlay
+#define FULL_SCALE_MILLI 400000
+#define INTEGRATION_MS   100
+
+static const struct device *fake = DEVICE_DT_GET(DT_NODELABEL(fake_light));
+static struct als als;
+
+// The normalized reading of a lux value, -1 if reading fails
+static int32_t read_lux(int32_t val1, int32_t val2) {
+    int32_t out;
+
+    fake_light_sensor_set(fake, val1, val2);
+    return als_read_normalized(&als, 0, &out) ? -1 : out;
+}
+
+static void als_before(void *fixture) {
+    ARG_UNUSED(fixture);
+
+    fake_light_sensor_set(fake, 0, 0);
+    fake_light_sensor_set_error(fake, 0);
+    zassert_ok(als_init(&als));
+}
+
+ZTEST(als, test_backend_from_devicetree) {
+    zassert_equal_ptr(als.dev, fake);
+    zassert_equal(strcmp(als.backend->name, "fake-light-sensor"), 0);
+    zassert_equal(als.backend->full_scale_milli, FULL_SCALE_MILLI);
+    zassert_equal(als.backend->integration_ms, INTEGRATION_MS);
+}
+
+ZTEST(als, test_normalizes_to_permille) {
+    zassert_equal(read_lux(0, 0), 0);
+    zassert_equal(read_lux(100, 0), 250);
+    zassert_equal(read_lux(400, 0), ALS_NORMALIZED_MAX);
+
+    // 1.5 lux is 3.75 permille, rounded down
+    zassert_equal(read_lux(1, 500000), 3);
+}
+
+ZTEST(als, test_clamps_to_range) {
+    zassert_equal(read_lux(401, 0), ALS_NORMALIZED_MAX);
+    zassert_equal(read_lux(100000, 0), ALS_NORMALIZED_MAX);
+    zassert_equal(read_lux(-5, 0), 0);
+}
+
+ZTEST(als, test_waits_for_integration) {
+    int32_t out;
+    uint32_t fetches = fake_light_sensor_fetches(fake);
+
+    // Asking sooner than the sensor integrates still waits for a fresh sample
+    int64_t start = k_uptime_get();
+    zassert_ok(als_read_normalized(&als, 10, &out));
+    zassert_true(k_uptime_get() - start >= INTEGRATION_MS);
+
+    start = k_uptime_get();
+    zassert_ok(als_read_normalized(&als, 250, &out));
+    zassert_true(k_uptime_get() - start >= 250);
+
+    // One fetch per reading
+    zassert_equal(fake_light_sensor_fetches(fake), fetches + 2);
+}
+
+ZTEST(als, test_fetch_error_is_returned) {
+    int32_t out = 42;
+
+    fake_light_sensor_set_error(fake, -EIO);
+    zassert_equal(als_read_normalized(&als, 0, &out), -EIO);
+    zassert_equal(out, 42);
+}
+
+ZTEST_SUITE(als, NULL, NULL, als_before, NULL, NULL);
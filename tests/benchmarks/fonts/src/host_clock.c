@@ -0,0 +1,14 @@
+/*
+ * Built into the native simulator runner rather than the Zephyr image, so it
+ * is compiled against and calls into the host's C library.
+ */
+#include "host_clock.h"
+
+#include <time.h>
+
+uint64_t host_clock_ns(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * The host's monotonic clock in ns. Simulated time on native_sim stands still
+ * while code runs, so k_cycle_get_32() cannot time drawing.
+ */
+uint64_t host_clock_ns(void);
@@ -0,0 +1,452 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include <lvgl.h>
+
+#include <glyph_cache_size.h>
+#include <sf_symbols.h>
+
+#include "host_clock.h"
+#include "widgets/fade_overlay.h"
+#include "widgets/glyph_cache.h"
+#include "widgets/layer_roller_fade.h"
+#include "widgets/render_profile.h"
+#include "widgets/text_image.h"
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+#include "widgets/gradient_cache.h"
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#define BENCH_DISP_W     240
+#define BENCH_DISP_H     280
+#define BENCH_ITERATIONS 200
+
+// Tall enough for the 56 px fonts; wider text is clipped but still measured
+#define BENCH_CANVAS_W BENCH_DISP_W
+#define BENCH_CANVAS_H 72
+
+// Layer names and numbers, in characters every font has
+#define BENCH_TEXT "BASE NAV SYM FN 0123456789"
+
+// What the firmware draws in each font of fonts.h. CMakeLists.txt fits the glyph cache to
+// LAYER_TEXT, so keep the two in sync
+#define LAYER_TEXT   "BASE LOWER RAISE ADJUST"
+#define NUMBERS_TEXT "100 85 7 N/A 42 WPM"
+#define SYMBOLS_TEXT                                                                               \
+    SF_SYMBOL_CONTROL SF_SYMBOL_OPTION SF_SYMBOL_SHIFT SF_SYMBOL_COMMAND                           \
+        SF_SYMBOL_CHARACTER_CURSOR_IBEAM
+
+// X(font, suffix, text) for each font in fonts.h, suffix naming a generated variant
+#define USED_FONTS(X, suffix)                                                                      \
+    X(FRAC_Thin_48, suffix, LAYER_TEXT)                                                            \
+    X(FRAC_Regular_48, suffix, LAYER_TEXT)                                                         \
+    X(FoundryGridnikMedium_20, suffix, NUMBERS_TEXT)                                               \
+    X(SF_Compact_Text_Bold_32, suffix, SYMBOLS_TEXT)
+
+#define USED_FONT_COUNT 4
+
+// The fonts in fonts.h that CONFIG_PROSPECTOR_GLYPH_CACHE caches
+#define LAYER_FONTS(X, suffix)                                                                     \
+    X(FRAC_Thin_48, suffix, LAYER_TEXT)                                                            \
+    X(FRAC_Regular_48, suffix, LAYER_TEXT)
+
+#define LAYER_FONT_COUNT 2
+
+static const char *const layer_names[] = {"BASE", "LOWER", "RAISE", "ADJUST"};
+
+// The layer roller as custom_status_screen.c places it
+#define BENCH_ROLLER_W       224
+#define BENCH_ROLLER_H       140
+#define BENCH_ROLLER_OPTIONS "BASE\nLOWER\nRAISE\nADJUST"
+
+// CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_*
+enum bench_fade {
+    BENCH_FADE_NONE,
+    BENCH_FADE_MASK,
+    BENCH_FADE_OVERLAY,
+};
+
+static const char *const fade_names[] = {"none", "mask", "overlay"};
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_MASK)
+#define BENCH_PROFILE_FADE BENCH_FADE_MASK
+#elif IS_ENABLED(CONFIG_PROSPECTOR_LAYER_ROLLER_FADE_OVERLAY)
+#define BENCH_PROFILE_FADE BENCH_FADE_OVERLAY
+#else
+#define BENCH_PROFILE_FADE BENCH_FADE_NONE
+#endif
+
+// The battery bars of a two-half split, as battery_bar.c lays them out
+#define BENCH_BARS      2
+#define BENCH_BAR_W     98
+#define BENCH_BAR_H     4
+#define BENCH_GRAD_FROM 0x909090
+#define BENCH_GRAD_TO   0xf0f0f0
+
+struct bench_font {
+    const char *name;
+    const lv_font_t *font;
+    // Defined by the generated fonts, see --flash-bytes in subset_fonts.py
+    const size_t *flash_bytes;
+};
+
+struct bench_variant {
+    const char *name;
+    const char *variant;
+    const lv_font_t *font;
+    const size_t *flash_bytes;
+    const char *text;
+};
+
+struct text_cost {
+    uint32_t glyphs;
+    uint32_t bitmap_bytes;
+    uint32_t pixels;
+};
+
+#define BENCH_FONT(name)                                                                           \
+    extern const lv_font_t name;                                                                   \
+    extern const size_t name##_flash_bytes;
+#include "benchmark_fonts.h"
+#undef BENCH_FONT
+
+#define BENCH_FONT(name) {#name, &name, &name##_flash_bytes},
+static const struct bench_font all_fonts[] = {
+#include "benchmark_fonts.h"
+};
+#undef BENCH_FONT
+
+#define DECLARE_VARIANT(font, suffix, text)                                                        \
+    extern const lv_font_t font##suffix;                                                           \
+    extern const size_t font##suffix##_flash_bytes;
+USED_FONTS(DECLARE_VARIANT, _2bpp)
+USED_FONTS(DECLARE_VARIANT, _1bpp)
+LAYER_FONTS(DECLARE_VARIANT, _rle)
+
+#define VARIANT(font, suffix, text) {#font, #suffix, &font##suffix, &font##suffix##_flash_bytes, text},
+
+// CONFIG_PROSPECTOR_FONT_BPP_*: the same glyphs with fewer bits per pixel
+static const struct bench_variant by_bpp[][USED_FONT_COUNT] = {
+    {USED_FONTS(VARIANT, )},
+    {USED_FONTS(VARIANT, _2bpp)},
+    {USED_FONTS(VARIANT, _1bpp)},
+};
+
+// CONFIG_PROSPECTOR_FONT_COMPRESS: the same glyphs RLE compressed
+static const struct bench_variant by_format[][LAYER_FONT_COUNT] = {
+    {LAYER_FONTS(VARIANT, )},
+    {LAYER_FONTS(VARIANT, _rle)},
+};
+
+static lv_color_t frame[BENCH_DISP_W * BENCH_DISP_H];
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
+static lv_disp_t *disp;
+
+static uint8_t canvas_buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR(BENCH_CANVAS_W, BENCH_CANVAS_H)] __aligned(4);
+static uint8_t image_buf[LV_IMG_BUF_SIZE_ALPHA_4BIT(BENCH_CANVAS_W, BENCH_CANVAS_H)] __aligned(4);
+
+static void bench_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *px) {
+    lv_disp_flush_ready(drv);
+}
+
+/*
+ * A display of our own, so results do not depend on the pixel format the
+ * dummy display reports. Full frame buffering, like LV_Z_VDB_SIZE=100.
+ */
+static void bench_display_init(void) {
+    lv_disp_draw_buf_init(&draw_buf, frame, NULL, ARRAY_SIZE(frame));
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = BENCH_DISP_W;
+    disp_drv.ver_res = BENCH_DISP_H;
+    disp_drv.flush_cb = bench_flush_cb;
+    disp_drv.draw_buf = &draw_buf;
+    disp = lv_disp_drv_register(&disp_drv);
+    lv_disp_set_default(disp);
+}
+
+// What drawing text reads and blends, glyph by glyph
+static void bench_measure(const lv_font_t *font, const char *text, struct text_cost *cost) {
+    uint32_t i = 0;
+
+    while (text[i] != '\0') {
+        uint32_t letter;
+        uint32_t letter_next;
+        lv_font_glyph_dsc_t g;
+
+        _lv_txt_encoded_letter_next_2(text, &letter, &letter_next, &i);
+        if (!lv_font_get_glyph_dsc(font, &g, letter, letter_next) || g.box_w == 0) {
+            continue;
+        }
+
+        cost->glyphs++;
+        cost->pixels += g.box_w * g.box_h;
+        cost->bitmap_bytes += DIV_ROUND_UP(g.box_w * g.box_h * g.bpp, 8);
+    }
+}
+
+static void bench_text_header(const char *title) {
+    printk("\n%s, %d iterations\n", title, BENCH_ITERATIONS);
+    printk("%-30s %-10s %3s %6s %8s %8s %8s %8s\n", "font", "variant", "bpp", "glyphs",
+           "ns/glyph", "B/glyph", "px/glyph", "flash B");
+}
+
+static void bench_text(lv_obj_t *canvas, const char *name, const char *variant,
+                       const lv_font_t *font, const lv_font_t *base, size_t flash_bytes,
+                       const char *text) {
+    const lv_font_fmt_txt_dsc_t *dsc = base->dsc;
+    struct text_cost cost = {0};
+    lv_draw_label_dsc_t label;
+
+    lv_draw_label_dsc_init(&label);
+    label.font = font;
+    label.color = lv_color_white();
+
+    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+
+    uint64_t start = host_clock_ns();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        lv_canvas_draw_text(canvas, 0, 0, BENCH_CANVAS_W, &label, text);
+    }
+    uint64_t ns = host_clock_ns() - start;
+
+    bench_measure(font, text, &cost);
+    if (cost.glyphs == 0) {
+        printk("%-30s %-10s no glyphs to draw\n", name, variant);
+        return;
+    }
+
+    printk("%-30s %-10s %3u %6u %8u %8u %8u %8zu\n", name, variant, dsc->bpp, cost.glyphs,
+           (uint32_t)(ns / ((uint64_t)cost.glyphs * BENCH_ITERATIONS)),
+           cost.bitmap_bytes / cost.glyphs, cost.pixels / cost.glyphs, flash_bytes);
+}
+
+static void bench_layer_image_header(void) {
+    printk("\nLayer names as text and as images, %d iterations\n", BENCH_ITERATIONS);
+    printk("%-30s %-8s %8s %8s %8s %9s\n", "font", "name", "text ns", "image ns", "image B",
+           "render ns");
+}
+
+/*
+ * CONFIG_PROSPECTOR_LAYER_NAME_IMAGES: the carousel blits a name rendered
+ * once at boot, tinted by the recolor style, instead of drawing its glyphs.
+ */
+static void bench_layer_image(lv_obj_t *canvas, const char *font_name, const lv_font_t *font,
+                              const char *name) {
+    lv_draw_label_dsc_t label;
+    lv_draw_img_dsc_t image;
+    lv_img_dsc_t img;
+
+    lv_draw_label_dsc_init(&label);
+    label.font = font;
+    label.color = lv_color_white();
+
+    lv_draw_img_dsc_init(&image);
+    image.recolor = lv_color_white();
+    image.recolor_opa = LV_OPA_COVER;
+
+    uint64_t start = host_clock_ns();
+    int bytes = text_image_render(&img, image_buf, sizeof(image_buf), name, font, BENCH_CANVAS_W);
+    uint64_t render_ns = host_clock_ns() - start;
+    if (bytes < 0) {
+        printk("%-30s %-8s image does not fit\n", font_name, name);
+        return;
+    }
+
+    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+    start = host_clock_ns();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        lv_canvas_draw_text(canvas, 0, 0, BENCH_CANVAS_W, &label, name);
+    }
+    uint64_t text_ns = host_clock_ns() - start;
+
+    lv_canvas_fill_bg(canvas, lv_color_black(), LV_OPA_COVER);
+    start = host_clock_ns();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        lv_canvas_draw_img(canvas, 0, 0, &img, &image);
+    }
+    uint64_t image_ns = host_clock_ns() - start;
+
+    printk("%-30s %-8s %8u %8u %8d %9u\n", font_name, name,
+           (uint32_t)(text_ns / BENCH_ITERATIONS), (uint32_t)(image_ns / BENCH_ITERATIONS), bytes,
+           (uint32_t)render_ns);
+}
+
+// Everything above and below the selected row, as layer_roller.c sizes the fade overlay
+static lv_coord_t bench_band_height(lv_obj_t *roller) {
+    const lv_font_t *font = lv_obj_get_style_text_font(roller, LV_PART_MAIN);
+    lv_coord_t line_space = lv_obj_get_style_text_line_space(roller, LV_PART_MAIN);
+
+    return (lv_obj_get_height(roller) - lv_font_get_line_height(font) - line_space) / 2;
+}
+
+// A roller styled like layer_roller.c, fonts uncached
+static lv_obj_t *bench_roller_create(lv_obj_t *parent, enum bench_fade fade) {
+    lv_obj_t *roller = lv_roller_create(parent);
+    struct fade_overlay overlay;
+
+    lv_obj_set_style_bg_color(roller, lv_color_black(), 0);
+    lv_obj_set_style_border_width(roller, 0, 0);
+    lv_obj_set_style_pad_all(roller, 0, 0);
+    lv_obj_set_style_text_font(roller, &FRAC_Thin_48, LV_PART_MAIN);
+    lv_obj_set_style_text_color(roller, lv_color_hex(0x909090), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(roller, LV_OPA_TRANSP, LV_PART_SELECTED);
+    lv_obj_set_style_text_font(roller, &FRAC_Regular_48, LV_PART_SELECTED);
+    lv_obj_set_style_text_color(roller, lv_color_white(), LV_PART_SELECTED);
+    lv_roller_set_options(roller, BENCH_ROLLER_OPTIONS, LV_ROLLER_MODE_INFINITE);
+    lv_obj_set_size(roller, BENCH_ROLLER_W, BENCH_ROLLER_H);
+
+    if (fade == BENCH_FADE_MASK) {
+        lv_obj_add_event_cb(roller, layer_roller_fade_mask_cb, LV_EVENT_ALL, NULL);
+    } else if (fade == BENCH_FADE_OVERLAY) {
+        fade_overlay_create(&overlay, roller);
+        lv_obj_update_layout(roller);
+        fade_overlay_set_band_height(&overlay, bench_band_height(roller));
+    }
+
+    return roller;
+}
+
+// Average time to redraw all of obj
+static uint32_t bench_redraw_ns(lv_obj_t *obj) {
+    lv_refr_now(disp);
+
+    uint64_t start = host_clock_ns();
+    for (int n = 0; n < BENCH_ITERATIONS; n++) {
+        lv_obj_invalidate(obj);
+        lv_refr_now(disp);
+    }
+
+    return (host_clock_ns() - start) / BENCH_ITERATIONS;
+}
+
+static void bench_fade(enum bench_fade fade) {
+    lv_obj_t *roller = bench_roller_create(lv_scr_act(), fade);
+
+    printk("%-10s %10u %8d\n", fade_names[fade], bench_redraw_ns(roller),
+           BENCH_ROLLER_W * BENCH_ROLLER_H);
+
+    lv_obj_del(roller);
+}
+
+// A full battery bar with the indicator fill battery_bar.c picks for the profile
+static lv_obj_t *bench_bar_create(lv_obj_t *parent, const lv_img_dsc_t *grad) {
+    lv_obj_t *bar = lv_bar_create(parent);
+
+    lv_obj_set_style_bg_color(bar, lv_color_hex(0x202020), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_radius(bar, 1, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, LV_PART_INDICATOR);
+    lv_obj_set_style_radius(bar, 1, LV_PART_INDICATOR);
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+    lv_obj_set_style_bg_color(bar, lv_color_hex(BENCH_GRAD_FROM), LV_PART_INDICATOR);
+    lv_obj_set_style_bg_img_tiled(bar, true, LV_PART_INDICATOR);
+    lv_obj_set_style_bg_img_src(bar, grad, LV_PART_INDICATOR);
+#elif PROSPECTOR_BAR_GRADIENT
+    lv_obj_set_style_bg_color(bar, lv_color_hex(BENCH_GRAD_FROM), LV_PART_INDICATOR);
+    lv_obj_set_style_bg_grad_color(bar, lv_color_hex(BENCH_GRAD_TO), LV_PART_INDICATOR);
+    lv_obj_set_style_bg_dither_mode(bar, PROSPECTOR_BAR_DITHER, LV_PART_INDICATOR);
+    lv_obj_set_style_bg_grad_dir(bar, LV_GRAD_DIR_HOR, LV_PART_INDICATOR);
+#else
+    lv_obj_set_style_bg_color(bar, lv_color_hex(0xc0c0c0), LV_PART_INDICATOR);
+#endif
+    lv_obj_set_size(bar, BENCH_BAR_W, BENCH_BAR_H);
+    lv_bar_set_value(bar, 100, LV_ANIM_OFF);
+
+    return bar;
+}
+
+/*
+ * The layer roller and battery bars of the status screen, drawn with the
+ * fade and bar fill this build's render profile picks.
+ */
+static void bench_profile(void) {
+    lv_obj_t *scr = lv_scr_act();
+    const lv_img_dsc_t *grad = NULL;
+
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+    grad = gradient_cache_get(BENCH_BAR_W, BENCH_GRAD_FROM, BENCH_GRAD_TO);
+#endif
+
+    lv_obj_t *roller = bench_roller_create(scr, BENCH_PROFILE_FADE);
+    lv_obj_align(roller, LV_ALIGN_LEFT_MID, 0, -20);
+    for (int i = 0; i < BENCH_BARS; i++) {
+        lv_obj_t *bar = bench_bar_create(scr, grad);
+        lv_obj_align(bar, LV_ALIGN_BOTTOM_LEFT, 16 + i * (BENCH_BAR_W + 12), -12);
+    }
+
+    printk("%-10s %10u %8d\n", PROSPECTOR_RENDER_PROFILE_NAME, bench_redraw_ns(scr),
+           BENCH_DISP_W * BENCH_DISP_H);
+
+    lv_obj_clean(scr);
+#if IS_ENABLED(CONFIG_PROSPECTOR_GRADIENT_CACHE)
+    gradient_cache_release(grad);
+#endif
+}
+
+int main(void) {
+    bench_display_init();
+
+    lv_obj_t *canvas = lv_canvas_create(NULL);
+    lv_canvas_set_buffer(canvas, canvas_buf, BENCH_CANVAS_W, BENCH_CANVAS_H,
+                         LV_IMG_CF_TRUE_COLOR);
+
+    bench_text_header("Every font in src/fonts");
+    for (int i = 0; i < ARRAY_SIZE(all_fonts); i++) {
+        const struct bench_font *f = &all_fonts[i];
+        bench_text(canvas, f->name, "", f->font, f->font, *f->flash_bytes, BENCH_TEXT);
+    }
+
+    bench_text_header("Fonts in fonts.h by bits per pixel");
+    for (int i = 0; i < USED_FONT_COUNT; i++) {
+        for (int v = 0; v < ARRAY_SIZE(by_bpp); v++) {
+            const struct bench_variant *f = &by_bpp[v][i];
+            bench_text(canvas, f->name, f->variant, f->font, f->font, *f->flash_bytes, f->text);
+        }
+    }
+
+    /*
+     * Cached glyphs cost no flash but RAM, sized as the firmware sizes it by
+     * default; the cache logs its hit rate as it goes.
+     */
+    bench_text_header("Layer name fonts, RLE compressed and glyph cached");
+    printk("Glyph cache: %d bytes for %d glyphs\n", PROSPECTOR_LAYER_GLYPH_BYTES,
+           PROSPECTOR_LAYER_GLYPHS);
+    for (int i = 0; i < LAYER_FONT_COUNT; i++) {
+        for (int v = 0; v < ARRAY_SIZE(by_format); v++) {
+            const struct bench_variant *f = &by_format[v][i];
+            char cached[16];
+
+            snprintk(cached, sizeof(cached), "%s+cache", f->variant);
+            bench_text(canvas, f->name, f->variant, f->font, f->font, *f->flash_bytes, f->text);
+            bench_text(canvas, f->name, cached, glyph_cache_font(f->font), f->font,
+                       *f->flash_bytes, f->text);
+        }
+    }
+
+    // Regular for the current layer, thin for its neighbours
+    bench_layer_image_header();
+    for (int i = 0; i < ARRAY_SIZE(layer_names); i++) {
+        bench_layer_image(canvas, "FRAC_Regular_48", &FRAC_Regular_48, layer_names[i]);
+        bench_layer_image(canvas, "FRAC_Thin_48", &FRAC_Thin_48, layer_names[i]);
+    }
+
+    lv_obj_del(canvas);
+
+    printk("\nLayer roller fades, %d iterations\n", BENCH_ITERATIONS);
+    printk("%-10s %10s %8s\n", "fade", "ns/frame", "px/frame");
+    for (int fade = BENCH_FADE_NONE; fade <= BENCH_FADE_OVERLAY; fade++) {
+        bench_fade(fade);
+    }
+
+    printk("\nStatus screen, %d iterations, %d ms battery bar animation\n", BENCH_ITERATIONS,
+           PROSPECTOR_ANIM_MS(250));
+    printk("%-10s %10s %8s\n", "profile", "ns/frame", "px/frame");
+    bench_profile();
+
+    printk("\nFont benchmark done\n");
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <zephyr/ztest.h>
+
+#include "wpm_window.h"
+
+#define LEN_S 10
+#define T0    1000
+
+static struct wpm_window w;
+
+static void add_n(uint32_t now_s, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        wpm_window_add(&w, now_s);
+    }
+}
+
+ZTEST(wpm_window, test_init_clamps_length) {
+    wpm_window_init(&w, 0, T0);
+    zassert_equal(w.len_s, 1);
+
+    wpm_window_init(&w, WPM_WINDOW_MAX_S + 1, T0);
+    zassert_equal(w.len_s, WPM_WINDOW_MAX_S);
+}
+
+ZTEST(wpm_window, test_rate_formula) {
+    // 50 keystrokes are 10 words, in 10 s that is 60 per minute
+    wpm_window_init(&w, LEN_S, T0);
+    add_n(T0, 50);
+    zassert_equal(wpm_window_wpm(&w, T0), 60);
+
+    // Rounded down: 7 keystrokes in 10 s are 8.4 WPM
+    wpm_window_init(&w, LEN_S, T0);
+    add_n(T0, 7);
+    zassert_equal(wpm_window_wpm(&w, T0), 8);
+
+    // Over a full minute the rate is simply words typed
+    wpm_window_init(&w, WPM_WINDOW_MAX_S, T0);
+    add_n(T0, 300);
+    zassert_equal(wpm_window_wpm(&w, T0 + WPM_WINDOW_MAX_S - 1), 60);
+}
+
+ZTEST(wpm_window, test_buckets_expire_after_len_s) {
+    wpm_window_init(&w, LEN_S, T0);
+    add_n(T0, 5);
+    add_n(T0 + 5, 5);
+
+    zassert_equal(wpm_window_wpm(&w, T0 + LEN_S - 1), 10 * 60 / (LEN_S * 5));
+    zassert_equal(w.sum, 10);
+
+    // The first second leaves the window, the second one is still in it
+    wpm_window_wpm(&w, T0 + LEN_S);
+    zassert_equal(w.sum, 5);
+
+    wpm_window_wpm(&w, T0 + 5 + LEN_S);
+    zassert_equal(w.sum, 0);
+}
+
+ZTEST(wpm_window, test_ring_wraparound) {
+    wpm_window_init(&w, LEN_S, T0);
+
+    // One press a second for several laps around the ring
+    for (uint32_t t = T0; t < T0 + 3 * LEN_S + 3; t++) {
+        wpm_window_add(&w, t);
+        zassert_equal(w.sum, MIN(t - T0 + 1, LEN_S), "at %u s", t - T0);
+    }
+
+    zassert_equal(wpm_window_wpm(&w, T0 + 3 * LEN_S + 2), LEN_S * 60 / (LEN_S * 5));
+}
+
+ZTEST(wpm_window, test_clock_wraparound) {
+    uint32_t start = UINT32_MAX - 2;
+
+    wpm_window_init(&w, LEN_S, start);
+    add_n(start, 5);
+    add_n(start + 4, 5);
+
+    // start + 4 wrapped to 1; both seconds are still in the window
+    zassert_equal(w.head_s, 1);
+    zassert_equal(w.sum, 10);
+
+    wpm_window_wpm(&w, start + LEN_S);
+    zassert_equal(w.sum, 5);
+}
+
+ZTEST(wpm_window, test_gap_of_len_s_or_more) {
+    wpm_window_init(&w, LEN_S, T0);
+    add_n(T0, 20);
+
+    zassert_equal(wpm_window_wpm(&w, T0 + LEN_S), 0);
+    zassert_equal(w.sum, 0);
+
+    // A long idle period clears everything at once, and counting resumes from there
+    add_n(T0 + LEN_S + 1, 3);
+    zassert_equal(wpm_window_wpm(&w, T0 + 100000), 0);
+    add_n(T0 + 100000, 5);
+    zassert_equal(w.sum, 5);
+    for (int i = 0; i < WPM_WINDOW_MAX_S; i++) {
+        zassert_true(w.buckets[i] <= 5);
+    }
+}
+
+ZTEST(wpm_window, test_time_going_backwards) {
+    wpm_window_init(&w, LEN_S, T0);
+    add_n(T0, 5);
+
+    // Earlier timestamps land in the newest bucket instead of rewinding the window
+    add_n(T0 - 3, 5);
+    zassert_equal(w.head_s, T0);
+    zassert_equal(w.sum, 10);
+    zassert_equal(wpm_window_wpm(&w, T0 - 100), wpm_window_wpm(&w, T0));
+
+    wpm_window_wpm(&w, T0 + LEN_S);
+    zassert_equal(w.sum, 0);
+}
+
+ZTEST(wpm_window, test_bucket_saturation) {
+    wpm_window_init(&w, LEN_S, T0);
+    add_n(T0, UINT16_MAX + 10);
+
+    zassert_equal(w.buckets[T0 % LEN_S], UINT16_MAX);
+    zassert_equal(w.sum, UINT16_MAX);
+
+    // Other seconds still count, and expiring the full bucket leaves nothing behind
+    add_n(T0 + 1, 10);
+    zassert_equal(w.sum, UINT16_MAX + 10);
+
+    wpm_window_wpm(&w, T0 + LEN_S);
+    zassert_equal(w.sum, 10);
+    wpm_window_wpm(&w, T0 + 1 + LEN_S);
+    zassert_equal(w.sum, 0);
+}
+
+ZTEST_SUITE(wpm_window, NULL, NULL, NULL, NULL, NULL);